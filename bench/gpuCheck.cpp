@@ -0,0 +1,441 @@
+// Confere a simulação em compute shaders (GpuFlock) contra a da CPU sem
+// janela: contexto OpenGL 4.5 por EGL sem superfície, então roda com o Mesa
+// llvmpipe em máquinas sem GPU.
+//  make gpucheck && ./bin/gpucheck.exe --boids 5000 --ticks 60
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "EBO.hpp"
+#include "VAO.hpp"
+#include "glCompute.hpp"
+#include "gpuFlock.hpp"
+#include "mesh.hpp"
+#include "random.hpp"
+#include "scene.hpp"
+
+// Contexto OpenGL 4.5 core sem superfície (o desenho vai para um framebuffer próprio)
+static bool createContext()
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+        return false;
+    if (!eglBindAPI(EGL_OPENGL_API))
+        return false;
+
+    EGLint configAttribs[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig config = nullptr;
+    EGLint numConfigs = 0;
+    eglChooseConfig(display, configAttribs, &config, 1, &numConfigs);
+
+    EGLint contextAttribs[] = {EGL_CONTEXT_MAJOR_VERSION, 4, EGL_CONTEXT_MINOR_VERSION, 5,
+                               EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+    EGLContext context = eglCreateContext(display, numConfigs > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT)
+        return false;
+    return eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+}
+
+static void *loadProc(const char *name)
+{
+    return (void *)eglGetProcAddress(name);
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printUsage(const char *program)
+{
+    std::printf("uso: %s [opcoes]\n"
+                "  --boids N          quantidade de boids (padrao 5000)\n"
+                "  --ticks N          ticks conferidos (padrao 60)\n"
+                "  --dt F             passo de tempo em segundos (padrao 0.016667)\n"
+                "  --seed N           semente do gerador (padrao 1)\n"
+                "  --bounds X Y Z     limites do mundo (padrao 600 200 600)\n"
+                "  --trees N          arvores sorteadas, fora a central (padrao 15)\n"
+                "  --tree-area A      arvores em [-A, A] no plano XZ (padrao 500)\n"
+                "  --tolerance F      erro maximo de posicao/velocidade por tick (padrao 0.01)\n"
+                "  --shader ARQ       compute shader (padrao resource_files/shaders/flock.comp)\n",
+                program);
+}
+
+int main(int argc, char *argv[])
+{
+    int numBoids = 5000;
+    int numTicks = 60;
+    float deltaTime = 1.0f / 60.0f;
+    unsigned int seed = 1;
+    float boundX = 600.0f, boundY = 200.0f, boundZ = 600.0f;
+    int numTrees = DEFAULT_TREE_COUNT;
+    float treeArea = DEFAULT_TREE_AREA;
+    float tolerance = 0.01f;
+    std::string shaderPath = "resource_files/shaders/flock.comp";
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--boids" && hasValue)
+            numBoids = std::atoi(argv[++i]);
+        else if (arg == "--ticks" && hasValue)
+            numTicks = std::atoi(argv[++i]);
+        else if (arg == "--dt" && hasValue)
+            deltaTime = (float)std::atof(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--bounds" && i + 3 < argc)
+        {
+            boundX = (float)std::atof(argv[++i]);
+            boundY = (float)std::atof(argv[++i]);
+            boundZ = (float)std::atof(argv[++i]);
+        }
+        else if (arg == "--trees" && hasValue)
+            numTrees = std::atoi(argv[++i]);
+        else if (arg == "--tree-area" && hasValue)
+            treeArea = (float)std::atof(argv[++i]);
+        else if (arg == "--tolerance" && hasValue)
+            tolerance = (float)std::atof(argv[++i]);
+        else if (arg == "--shader" && hasValue)
+            shaderPath = argv[++i];
+        else
+        {
+            printUsage(argv[0]);
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+
+    if (numBoids < 1 || numTicks < 1 || numTrees < 0 || treeArea <= 0.0f)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (!createContext() || !gladLoadGLLoader((GLADloadproc)loadProc))
+    {
+        std::printf("sem contexto OpenGL por EGL\n");
+        return 1;
+    }
+    std::printf("OpenGL %s | %s\n", glGetString(GL_VERSION), glGetString(GL_RENDERER));
+    if (!loadComputeFunctions((GLADloadproc)loadProc))
+    {
+        std::printf("compute shaders indisponiveis (precisa de OpenGL 4.3)\n");
+        return 1;
+    }
+
+    // Mesmo cenário do headless
+    setGlobalSeed(seed);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> randomX(-boundX, boundX);
+    std::uniform_real_distribution<float> randomY(10.0f, boundY);
+    std::uniform_real_distribution<float> randomZ(-boundZ, boundZ);
+    std::uniform_real_distribution<float> randomVel(-10.0f, 10.0f);
+
+    Flock flock;
+    for (int i = 0; i < numBoids; i++)
+    {
+        flock.add(glm::vec3(randomX(gen), randomY(gen), randomZ(gen)),
+                  glm::vec3(randomVel(gen), randomVel(gen), randomVel(gen)));
+    }
+    placeTrees(numTrees, treeArea);
+
+    GpuFlock gpuFlock;
+    if (!gpuFlock.init(shaderPath.c_str()))
+    {
+        std::printf("falha ao compilar %s\n", shaderPath.c_str());
+        return 1;
+    }
+
+    // Cada tick parte do mesmo estado nas duas: o erro não se acumula, então
+    // qualquer diferença acima da tolerância é erro do kernel e não caos
+    float maxPositionError = 0.0f, maxVelocityError = 0.0f, maxCenterError = 0.0f;
+    long failures = 0;
+    double gpuMs = 0.0, cpuMs = 0.0;
+    std::vector<Boid> gpuResult;
+    for (int tick = 0; tick < numTicks; tick++)
+    {
+        gpuResult = flock.getBoids();
+        gpuFlock.upload(flock);
+        glFinish();
+        auto gpuStart = std::chrono::steady_clock::now();
+        gpuFlock.update(deltaTime, boundX, boundY, boundZ);
+        glFinish();
+        gpuMs += millisecondsSince(gpuStart);
+        gpuFlock.download(gpuResult);
+        glm::vec3 gpuCenter = gpuFlock.readStats().center;
+
+        auto cpuStart = std::chrono::steady_clock::now();
+        flock.update(deltaTime, boundX, boundY, boundZ);
+        cpuMs += millisecondsSince(cpuStart);
+
+        const std::vector<Boid> &cpuResult = flock.getBoids();
+        for (size_t i = 0; i < cpuResult.size(); i++)
+        {
+            float positionError = glm::length(cpuResult[i].position - gpuResult[i].position);
+            float velocityError = glm::length(cpuResult[i].velocity - gpuResult[i].velocity);
+            // NaN também conta como falha
+            if (!(positionError <= tolerance && velocityError <= tolerance))
+                failures++;
+            maxPositionError = glm::max(maxPositionError, positionError);
+            maxVelocityError = glm::max(maxVelocityError, velocityError);
+        }
+        maxCenterError = glm::max(maxCenterError, glm::length(gpuCenter - flock.getStats().center));
+    }
+
+    // Instâncias interpoladas do desenho contra Boid::getModelMatrix
+    float maxInstanceError = 0.0f;
+    {
+        gpuResult = flock.getBoids();
+        gpuFlock.upload(flock);
+        gpuFlock.update(deltaTime, boundX, boundY, boundZ);
+        gpuFlock.download(gpuResult);
+        VBO instances(nullptr, 0, GL_STREAM_DRAW);
+        gpuFlock.writeInstances(instances, 0.5f, true);
+        std::vector<float> instanceData((size_t)numBoids * GPU_INSTANCE_FLOATS);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        instances.Bind();
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, instanceData.size() * sizeof(float), instanceData.data());
+        instances.Unbind();
+        for (int i = 0; i < numBoids; i++)
+        {
+            glm::mat4 model = gpuResult[i].getModelMatrix(0.5f);
+            const float *gpuInstance = &instanceData[(size_t)i * GPU_INSTANCE_FLOATS];
+            for (int k = 0; k < 16; k++)
+                maxInstanceError = glm::max(maxInstanceError, std::abs(model[k / 4][k % 4] - gpuInstance[k]));
+            maxInstanceError = glm::max(maxInstanceError, std::abs(gpuResult[i].getWingPhase(0.5f) - gpuInstance[16]));
+        }
+        instances.Delete();
+    }
+
+    // Culling e níveis de detalhe na GPU (instâncias compactadas por nível
+    // + contagens dos comandos indiretos) contra Flock::cull e LodSelector
+    // com o mesmo frustum e a mesma câmera
+    size_t cullMismatches = 0;
+    GLuint gpuVisible = 0;
+    GLuint gpuLevels[LOD_LEVELS] = {};
+    size_t cpuLevels[LOD_LEVELS] = {};
+    std::vector<uint32_t> cpuVisible;
+    {
+        glm::vec3 eye(-700.0f, 120.0f, 100.0f);
+        glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f, 50.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1200.0f);
+        Frustum frustum;
+        frustum.extract(projection * view);
+        LodSelector lod;
+        lod.update(eye, 60.0f, 1080);
+        const float radius = 2.0f;
+        const GLuint indexCounts[LOD_LEVELS] = {36, 24, 12, 1};
+
+        gpuFlock.upload(flock);
+        VBO instances(nullptr, 0, GL_STREAM_DRAW);
+        gpuFlock.writeVisibleInstances(instances, 0.5f, true, &frustum, radius, lod, indexCounts);
+        gpuVisible = gpuFlock.readVisibleCount();
+        for (int level = 0; level < LOD_LEVELS; level++)
+            gpuLevels[level] = gpuFlock.readVisibleCount(level);
+        flock.cull(frustum, 0.5f, radius, cpuVisible);
+
+        // A ordem dentro de cada nível é a das atomicAdd: compara os
+        // centros ordenados por (nível, posição)
+        size_t regionSize = (size_t)gpuFlock.size();
+        std::vector<float> instanceData((size_t)LOD_LEVELS * regionSize * GPU_INSTANCE_FLOATS);
+        instances.Bind();
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, instanceData.size() * sizeof(float), instanceData.data());
+        instances.Unbind();
+        instances.Delete();
+        auto byLevelAndPosition = [](const glm::vec4 &a, const glm::vec4 &b)
+        {
+            if (a.w != b.w)
+                return a.w < b.w;
+            return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+        };
+        std::vector<glm::vec4> gpuCenters, cpuCenters;
+        for (int level = 0; level < LOD_LEVELS; level++)
+        {
+            for (GLuint i = 0; i < gpuLevels[level]; i++)
+            {
+                size_t slot = (size_t)level * regionSize + i;
+                gpuCenters.push_back(glm::vec4(glm::make_vec3(&instanceData[slot * GPU_INSTANCE_FLOATS + 12]), (float)level));
+            }
+        }
+        for (uint32_t index : cpuVisible)
+        {
+            const Boid &boid = flock.getBoids()[index];
+            glm::vec3 center = glm::mix(boid.prevPosition, boid.position, 0.5f);
+            int level = lod.select(center, radius);
+            cpuLevels[level]++;
+            cpuCenters.push_back(glm::vec4(center, (float)level));
+        }
+        std::sort(gpuCenters.begin(), gpuCenters.end(), byLevelAndPosition);
+        std::sort(cpuCenters.begin(), cpuCenters.end(), byLevelAndPosition);
+        cullMismatches = gpuCenters.size() > cpuCenters.size() ? gpuCenters.size() - cpuCenters.size() : cpuCenters.size() - gpuCenters.size();
+        for (size_t i = 0; i < std::min(gpuCenters.size(), cpuCenters.size()); i++)
+        {
+            if (gpuCenters[i].w != cpuCenters[i].w || glm::length(glm::vec3(gpuCenters[i] - cpuCenters[i])) > tolerance)
+                cullMismatches++;
+        }
+    }
+
+    // Desenho instanciado do default.vert (matriz e fase nas locations 4 a
+    // 8, uma chamada só) contra uma chamada por boid com os uniforms model e
+    // wingPhase: mesmo shader e mesmos valores, então a imagem deve ser igual
+    long drawMismatches = 0;
+    int drawnPixels = 0;
+    {
+        const int imageSize = 256;
+        GLuint framebuffer, renderbuffers[2];
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glGenRenderbuffers(2, renderbuffers);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, imageSize, imageSize);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, imageSize, imageSize);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+        glViewport(0, 0, imageSize, imageSize);
+        glEnable(GL_DEPTH_TEST);
+
+        glm::vec3 eye(-700.0f, 120.0f, 100.0f);
+        Shader shader("resource_files/shaders/default.vert", "resource_files/shaders/default.frag");
+        shader.Activate();
+        shader.SetMat4("camMatrix", glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 1200.0f) *
+                                        glm::lookAt(eye, glm::vec3(0.0f, 50.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+        shader.SetVec4("lightColor", glm::vec4(1.0f));
+        shader.SetVec3("lightPos", glm::vec3(10.0f, 10.0f, 10.0f));
+        shader.SetVec3("camPos", eye);
+        shader.SetInt("fogEnabled", 0);
+        GLint modelLoc = shader.GetUniformLocation("model");
+        GLint wingPhaseLoc = shader.GetUniformLocation("wingPhase");
+        GLint instancedLoc = shader.GetUniformLocation("instanced");
+
+        std::vector<float> birdVertices;
+        std::vector<uint32_t> birdIndices;
+        objLoader(birdVertices, birdIndices, "resource_files/models/bird.obj");
+        VAO bird;
+        bird.Bind();
+        VBO birdVBO(birdVertices);
+        EBO birdEBO(birdIndices);
+        bird.LinkAttrib(birdVBO, 0, 3, GL_FLOAT, 11 * sizeof(float), (void *)0);
+        bird.LinkAttrib(birdVBO, 1, 3, GL_FLOAT, 11 * sizeof(float), (void *)(3 * sizeof(float)));
+        bird.LinkAttrib(birdVBO, 2, 2, GL_FLOAT, 11 * sizeof(float), (void *)(6 * sizeof(float)));
+        bird.LinkAttrib(birdVBO, 3, 3, GL_FLOAT, 11 * sizeof(float), (void *)(8 * sizeof(float)));
+
+        const std::vector<Boid> &boids = flock.getBoids();
+        std::vector<float> instanceData(boids.size() * GPU_INSTANCE_FLOATS);
+        for (size_t i = 0; i < boids.size(); i++)
+        {
+            glm::mat4 model = boids[i].getModelMatrix(0.5f);
+            std::copy(glm::value_ptr(model), glm::value_ptr(model) + 16, &instanceData[i * GPU_INSTANCE_FLOATS]);
+            instanceData[i * GPU_INSTANCE_FLOATS + 16] = boids[i].getWingPhase(0.5f);
+        }
+        VBO instances(instanceData.data(), instanceData.size() * sizeof(float), GL_STREAM_DRAW);
+        for (int column = 0; column < 4; column++)
+            bird.LinkInstanceAttrib(instances, 4 + column, 4, GL_FLOAT, GPU_INSTANCE_FLOATS * sizeof(float), (void *)(column * 4 * sizeof(float)));
+        bird.LinkInstanceAttrib(instances, 8, 1, GL_FLOAT, GPU_INSTANCE_FLOATS * sizeof(float), (void *)(16 * sizeof(float)));
+
+        std::vector<unsigned char> instancedImage((size_t)imageSize * imageSize * 4), uniformImage(instancedImage.size());
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        shader.SetInt(instancedLoc, 1);
+        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)birdIndices.size(), GL_UNSIGNED_INT, 0, (GLsizei)boids.size());
+        glReadPixels(0, 0, imageSize, imageSize, GL_RGBA, GL_UNSIGNED_BYTE, instancedImage.data());
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        shader.SetInt(instancedLoc, 0);
+        for (const Boid &boid : boids)
+        {
+            shader.SetMat4(modelLoc, boid.getModelMatrix(0.5f));
+            shader.SetFloat(wingPhaseLoc, boid.getWingPhase(0.5f));
+            glDrawElements(GL_TRIANGLES, (GLsizei)birdIndices.size(), GL_UNSIGNED_INT, 0);
+        }
+        glReadPixels(0, 0, imageSize, imageSize, GL_RGBA, GL_UNSIGNED_BYTE, uniformImage.data());
+
+        for (size_t pixel = 0; pixel < (size_t)imageSize * imageSize; pixel++)
+        {
+            drawnPixels += uniformImage[pixel * 4 + 3] > 0 ? 1 : 0;
+            if (!std::equal(&instancedImage[pixel * 4], &instancedImage[pixel * 4] + 4, &uniformImage[pixel * 4]))
+                drawMismatches++;
+        }
+
+        bird.Unbind();
+        bird.Delete();
+        birdVBO.Delete();
+        birdEBO.Delete();
+        instances.Delete();
+        shader.Delete();
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteRenderbuffers(2, renderbuffers);
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+
+    // GPU sozinha a partir do estado atual (sem ida e volta por tick)
+    gpuFlock.upload(flock);
+    glFinish();
+    auto freeStart = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < numTicks; tick++)
+        gpuFlock.update(deltaTime, boundX, boundY, boundZ);
+    glFinish();
+    double freeMs = millisecondsSince(freeStart);
+
+    // Estatísticas por tick como na janela: getStats não espera a GPU e,
+    // depois de glFinish, tem de chegar à cópia do último update. readStats
+    // (leitura direta, que espera o tick terminar) fica só como comparação.
+    double asyncStatsMs = 0.0, syncStatsMs = 0.0;
+    for (int tick = 0; tick < numTicks; tick++)
+    {
+        gpuFlock.update(deltaTime, boundX, boundY, boundZ);
+        auto statsStart = std::chrono::steady_clock::now();
+        gpuFlock.getStats();
+        asyncStatsMs += millisecondsSince(statsStart);
+    }
+    glFinish();
+    FlockStats asyncStats = gpuFlock.getStats();
+    FlockStats exactStats = gpuFlock.readStats();
+    bool asyncStatsOk = asyncStats.count == exactStats.count && asyncStats.center == exactStats.center &&
+                        asyncStats.meanVelocity == exactStats.meanVelocity;
+    for (int tick = 0; tick < numTicks; tick++)
+    {
+        gpuFlock.update(deltaTime, boundX, boundY, boundZ);
+        auto statsStart = std::chrono::steady_clock::now();
+        gpuFlock.readStats();
+        syncStatsMs += millisecondsSince(statsStart);
+    }
+
+    std::printf("boids: %d  ticks: %d  dt: %g  seed: %u  arvores: %zu\n",
+                numBoids, numTicks, deltaTime, seed, globalTrees.size());
+    std::printf("erro maximo por tick: posicao %g  velocidade %g  centro %g\n",
+                maxPositionError, maxVelocityError, maxCenterError);
+    std::printf("erro maximo das instancias: %g\n", maxInstanceError);
+    std::printf("culling: gpu %u visiveis, cpu %zu (%zu divergencias)\n", gpuVisible, cpuVisible.size(), cullMismatches);
+    std::printf("niveis de detalhe: gpu %u/%u/%u/%u  cpu %zu/%zu/%zu/%zu\n", gpuLevels[0], gpuLevels[1], gpuLevels[2], gpuLevels[3],
+                cpuLevels[0], cpuLevels[1], cpuLevels[2], cpuLevels[3]);
+    std::printf("desenho instanciado: %d pixels desenhados, %ld diferentes de uma chamada por boid\n", drawnPixels, drawMismatches);
+    std::printf("leitura das estatisticas por tick: getStats %.3f ms, readStats %.3f ms%s\n",
+                asyncStatsMs / numTicks, syncStatsMs / numTicks, asyncStatsOk ? "" : " (getStats DIVERGE)");
+    std::printf("ms por tick: gpu %.3f (isolada %.3f)  cpu %.3f\n",
+                gpuMs / numTicks, freeMs / numTicks, cpuMs / numTicks);
+
+    gpuFlock.Delete();
+    if (failures > 0 || maxInstanceError > tolerance || cullMismatches > 0 || drawMismatches > 0 || drawnPixels == 0 || !asyncStatsOk)
+    {
+        std::printf("GPU x CPU: DIVERGE (%ld boid-ticks acima de %g)\n", failures, tolerance);
+        return 2;
+    }
+    std::printf("GPU x CPU: ok (tolerancia %g)\n", tolerance);
+    return 0;
+}
@@ -0,0 +1,453 @@
+// Simulação sem janela nem OpenGL para medir desempenho em máquinas sem GPU.
+//  make headless && ./bin/headless.exe --boids 50000 --ticks 200
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "flock.hpp"
+#include "random.hpp"
+#include "scene.hpp"
+#include "trace.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Contador de alocações de heap, para conferir que o tick não aloca
+static std::atomic<size_t> allocationCount(0);
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t align)
+{
+    allocationCount++;
+    size_t alignment = static_cast<size_t>(align);
+#ifdef _WIN32
+    if (void *p = _aligned_malloc(size ? size : 1, alignment))
+        return p;
+#else
+    if (void *p = std::aligned_alloc(alignment, ((size ? size : 1) + alignment - 1) / alignment * alignment))
+        return p;
+#endif
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete(void *p, size_t, std::align_val_t align) noexcept
+{
+    operator delete(p, align);
+}
+
+// Pico de memória residente do processo em MB
+static double peakResidentMB()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+    return 0.0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0; // ru_maxrss vem em KB no Linux
+#endif
+}
+
+// Hash FNV-1a dos bits de posição, velocidade e fase de todos os boids
+static unsigned long long stateHash(const Flock &flock)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    auto mix = [&](const void *data, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    for (const Boid &b : flock.getBoids())
+    {
+        mix(&b.position, sizeof(b.position));
+        mix(&b.velocity, sizeof(b.velocity));
+        mix(&b.wingPhase, sizeof(b.wingPhase));
+    }
+    return hash;
+}
+
+static void printUsage(const char *program)
+{
+    std::printf("uso: %s [opcoes]\n"
+                "  --boids N          quantidade de boids (padrao 10000)\n"
+                "  --ticks N          ticks medidos (padrao 200)\n"
+                "  --warmup N         ticks antes da medicao (padrao 5)\n"
+                "  --dt F             passo de tempo em segundos (padrao 0.016667)\n"
+                "  --seed N           semente do gerador (padrao 1)\n"
+                "  --bounds X Y Z     limites do mundo (padrao 600 200 600)\n"
+                "  --threads N        threads do update, 0 = todos os nucleos (padrao 0)\n"
+                "  --mode M           jacobi ou gauss-seidel (padrao jacobi)\n"
+                "  --perception R     raio de percepcao dos boids (padrao 50)\n"
+                "  --approx THETA     coesao/alinhamento pela octree com angulo de abertura\n"
+                "                     THETA (0 a 0.5); sem a opcao, busca exata\n"
+                "  --trees N          arvores sorteadas, fora a central (padrao 15)\n"
+                "  --tree-area A      arvores em [-A, A] no plano XZ (padrao 500)\n"
+                "  --golden ARQ       grava o hash do estado a cada tick em ARQ ou,\n"
+                "                     se ARQ ja existir, compara com ele\n"
+                "  --cull             mede tambem o frustum culling dos boids (camera\n"
+                "                     fixa olhando o mundo de cima e de lado)\n"
+                "  --trace ARQ        grava as zonas dos ticks medidos em ARQ (JSON do\n"
+                "                     chrome://tracing / Perfetto)\n"
+                "  --bulk N           mede add/remove em lote de N boids num bando a\n"
+                "                     parte e confere os handles depois da remocao\n",
+                program);
+}
+
+int main(int argc, char *argv[])
+{
+    int numBoids = 10000;
+    int numTicks = 200;
+    int warmupTicks = 5;
+    float deltaTime = 1.0f / 60.0f;
+    unsigned int seed = 1;
+    float boundX = 600.0f, boundY = 200.0f, boundZ = 600.0f;
+    unsigned int numThreads = 0;
+    UpdateMode mode = UpdateMode::Jacobi;
+    float perceptionRadius = 50.0f;
+    float openingAngle = -1.0f;
+    int numTrees = DEFAULT_TREE_COUNT;
+    float treeArea = DEFAULT_TREE_AREA;
+    std::string goldenPath;
+    std::string tracePath;
+    bool measureCull = false;
+    int bulkCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--boids" && hasValue)
+            numBoids = std::atoi(argv[++i]);
+        else if (arg == "--ticks" && hasValue)
+            numTicks = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue)
+            warmupTicks = std::atoi(argv[++i]);
+        else if (arg == "--dt" && hasValue)
+            deltaTime = (float)std::atof(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--bounds" && i + 3 < argc)
+        {
+            boundX = (float)std::atof(argv[++i]);
+            boundY = (float)std::atof(argv[++i]);
+            boundZ = (float)std::atof(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue)
+            numThreads = (unsigned int)std::atoi(argv[++i]);
+        else if (arg == "--mode" && hasValue)
+        {
+            std::string value = argv[++i];
+            if (value == "jacobi")
+                mode = UpdateMode::Jacobi;
+            else if (value == "gauss-seidel")
+                mode = UpdateMode::GaussSeidel;
+            else
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (arg == "--perception" && hasValue)
+            perceptionRadius = (float)std::atof(argv[++i]);
+        else if (arg == "--approx" && hasValue)
+            openingAngle = (float)std::atof(argv[++i]);
+        else if (arg == "--trees" && hasValue)
+            numTrees = std::atoi(argv[++i]);
+        else if (arg == "--tree-area" && hasValue)
+            treeArea = (float)std::atof(argv[++i]);
+        else if (arg == "--golden" && hasValue)
+            goldenPath = argv[++i];
+        else if (arg == "--trace" && hasValue)
+            tracePath = argv[++i];
+        else if (arg == "--cull")
+            measureCull = true;
+        else if (arg == "--bulk" && hasValue)
+            bulkCount = std::atoi(argv[++i]);
+        else
+        {
+            printUsage(argv[0]);
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+
+    if (numBoids < 1 || numTicks < 1 || warmupTicks < 0 || numTrees < 0 || treeArea <= 0.0f || bulkCount < 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Cenário: boids espalhados pelo mundo e as árvores de placeTrees (as de main.cpp)
+    setGlobalSeed(seed);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> randomX(-boundX, boundX);
+    std::uniform_real_distribution<float> randomY(10.0f, boundY);
+    std::uniform_real_distribution<float> randomZ(-boundZ, boundZ);
+    std::uniform_real_distribution<float> randomVel(-10.0f, 10.0f);
+
+    Flock flock;
+    flock.setThreadCount(numThreads);
+    flock.setUpdateMode(mode);
+    flock.setPerceptionRadius(perceptionRadius);
+    if (openingAngle >= 0.0f)
+    {
+        flock.setApproximation(true);
+        flock.setOpeningAngle(openingAngle);
+    }
+    for (int i = 0; i < numBoids; i++)
+    {
+        flock.add(glm::vec3(randomX(gen), randomY(gen), randomZ(gen)),
+                  glm::vec3(randomVel(gen), randomVel(gen), randomVel(gen)));
+    }
+
+    placeTrees(numTrees, treeArea);
+
+    // Primeiros ticks dimensionam os buffers internos (grade, cópia SoA)
+    for (int i = 0; i < warmupTicks; i++)
+        flock.update(deltaTime, boundX, boundY, boundZ);
+
+    // Trajetória de referência: hashes por tick, gravados ou comparados
+    std::vector<unsigned long long> goldenHashes;
+    bool recordGolden = false;
+    if (!goldenPath.empty())
+    {
+        std::ifstream goldenIn(goldenPath);
+        recordGolden = !goldenIn.is_open();
+        unsigned long long value;
+        while (goldenIn >> std::hex >> value)
+            goldenHashes.push_back(value);
+        if (recordGolden)
+            goldenHashes.reserve(numTicks);
+    }
+    int divergedTick = -1;
+
+    // Só os ticks medidos. Os anéis das threads (o desta e os do pool) são
+    // criados antes, para que os ticks medidos continuem sem alocação.
+    setTraceThreadName("principal");
+    if (!tracePath.empty())
+        flock.reserveTrace();
+    setTracingEnabled(!tracePath.empty());
+
+    size_t allocationsBefore = allocationCount;
+    double seconds = 0.0;
+    for (int i = 0; i < numTicks; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        flock.update(deltaTime, boundX, boundY, boundZ);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (goldenPath.empty())
+            continue;
+        unsigned long long hash = stateHash(flock);
+        if (recordGolden)
+            goldenHashes.push_back(hash);
+        else if (divergedTick < 0 && (i >= (int)goldenHashes.size() || goldenHashes[i] != hash))
+            divergedTick = i;
+    }
+    size_t allocations = allocationCount - allocationsBefore;
+    setTracingEnabled(false);
+
+    double boidTicks = (double)numBoids * numTicks;
+
+    std::printf("boids: %d  ticks: %d  dt: %g  seed: %u  threads: %u  modo: %s\n",
+                numBoids, numTicks, deltaTime, seed, flock.getThreadCount(),
+                mode == UpdateMode::Jacobi ? "jacobi" : "gauss-seidel");
+    std::printf("limites: %g x %g x %g  percepcao: %g\n", boundX, boundY, boundZ, perceptionRadius);
+    std::printf("arvores: %zu em [-%g, %g]\n", globalTrees.size(), treeArea, treeArea);
+    if (openingAngle >= 0.0f)
+        std::printf("octree: angulo de abertura %g\n", openingAngle);
+    std::printf("tempo total: %.3f s\n", seconds);
+    std::printf("ticks/s: %.2f\n", numTicks / seconds);
+    std::printf("ns por boid-tick: %.2f\n", seconds * 1e9 / boidTicks);
+    std::printf("alocacoes por tick: %.2f\n", (double)allocations / numTicks);
+    std::printf("pico de RSS: %.1f MB\n", peakResidentMB());
+    std::printf("hash do estado: %016llx\n", stateHash(flock));
+
+    // As estatísticas mantidas pelo update têm de cobrir todos os boids,
+    // inclusive depois de trocar o número de threads (o pool pode passar a
+    // entregar o intervalo inteiro de uma vez). Roda depois do hash para
+    // não mudar a trajetória medida.
+    unsigned int threadsBefore = flock.getThreadCount();
+    unsigned int threadsSwitched = threadsBefore > 1 ? 1 : 4;
+    int statsCount = flock.getStats().count;
+    flock.setThreadCount(threadsSwitched);
+    flock.update(deltaTime, boundX, boundY, boundZ);
+    int switchedCount = flock.getStats().count;
+    flock.setThreadCount(threadsBefore);
+    bool statsOk = statsCount == flock.size() && switchedCount == flock.size();
+    std::printf("estatisticas: %d de %d boids (%d com %u threads)%s\n", statsCount, flock.size(),
+                switchedCount, threadsSwitched, statsOk ? "" : " DIVERGE");
+    if (!statsOk)
+        return 2;
+
+    // O handle do líder não pode tirá-lo do índice 0 enquanto houver outros
+    // boids: o último iria para o lugar dele e o bando seguiria um boid comum
+    BoidHandle leader = flock.handleAt(0);
+    bool leaderRemoved = flock.remove(leader);
+    bool leaderOk = !leaderRemoved && flock.get(leader) == &flock.getBoids()[0] && flock.getBoids()[0].isObjective;
+    std::printf("lider: remove(handle) %s%s\n", leaderRemoved ? "aceito" : "recusado", leaderOk ? "" : " DIVERGE");
+    if (!leaderOk)
+        return 2;
+
+    if (measureCull)
+    {
+        // Câmera como a da janela (90 graus, 16:9, far 2000) a 700 do centro
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 150.0f, 700.0f), glm::vec3(0.0f, 50.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+        Frustum frustum;
+        frustum.extract(projection * view);
+        const float radius = 2.0f;
+
+        std::vector<uint32_t> visible;
+        flock.cull(frustum, 0.5f, radius, visible);
+        size_t allocationsBeforeCull = allocationCount;
+        auto cullStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < numTicks; i++)
+            flock.cull(frustum, 0.5f, radius, visible);
+        double cullSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - cullStart).count();
+        size_t cullAllocations = allocationCount - allocationsBeforeCull;
+
+        // Confere o kernel SIMD contra o teste escalar, boid a boid
+        size_t mismatches = 0, expected = 0, next = 0;
+        const std::vector<Boid> &boids = flock.getBoids();
+        for (size_t i = 0; i < boids.size(); i++)
+        {
+            bool inside = frustum.intersectsSphere(glm::mix(boids[i].prevPosition, boids[i].position, 0.5f), radius);
+            bool listed = next < visible.size() && visible[next] == i;
+            if (listed)
+                next++;
+            expected += inside ? 1 : 0;
+            mismatches += (inside != listed) ? 1 : 0;
+        }
+        std::printf("culling: %zu de %zu visiveis (%.1f%%)  ns por boid: %.2f  alocacoes: %zu  divergencias: %zu\n",
+                    visible.size(), boids.size(), 100.0 * visible.size() / boids.size(),
+                    cullSeconds * 1e9 / ((double)numBoids * numTicks), cullAllocations, mismatches);
+        if (mismatches > 0 || expected != visible.size())
+            return 2;
+    }
+    if (bulkCount > 0)
+    {
+        // Bando separado, só o líder no início: o simulado acima não muda
+        auto millisecondsSince = [](std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+        Flock bulk;
+        bulk.add();
+
+        auto start = std::chrono::steady_clock::now();
+        bulk.add(bulkCount);
+        double addMs = millisecondsSince(start);
+
+        std::vector<BoidHandle> handles;
+        for (size_t i = 0; i < (size_t)bulk.size(); i++)
+            handles.push_back(bulk.handleAt(i));
+
+        start = std::chrono::steady_clock::now();
+        bulk.removeRandom(bulkCount);
+        double removeMs = millisecondsSince(start);
+        bool bulkOk = bulk.size() == 1 && bulk.get(handles[0]) == &bulk.getBoids()[0];
+
+        bulk.add(bulkCount);
+
+        // Os slots dos removidos já foram reaproveitados pelos novos boids;
+        // os handles antigos (geração velha) têm de continuar sem boid
+        size_t staleValid = 0;
+        for (size_t i = 1; i < handles.size(); i++)
+            staleValid += bulk.get(handles[i]) != nullptr ? 1 : 0;
+        BoidHandle middle = bulk.handleAt(bulk.size() / 2);
+        bool removedOnce = bulk.remove(middle);
+        bool removedTwice = bulk.remove(middle);
+        bulkOk = bulkOk && staleValid == 0 && bulk.size() == bulkCount && removedOnce && !removedTwice &&
+                 bulk.get(middle) == nullptr && bulk.getStats().count == bulk.size();
+
+        // Lotes pequenos seguidos num bando novo: o vetor tem de crescer
+        // geometricamente, não um lote por vez
+        const int smallBatch = 10;
+        Flock batched;
+        batched.add();
+        start = std::chrono::steady_clock::now();
+        for (int added = 0; added < bulkCount; added += smallBatch)
+            batched.add(std::min(smallBatch, bulkCount - added));
+        double smallAddMs = millisecondsSince(start);
+
+        std::printf("lote de %d: add(count) %.3f ms  removeRandom %.3f ms  add(%d) repetido %.3f ms\n",
+                    bulkCount, addMs, removeMs, smallBatch, smallAddMs);
+        std::printf("handles: %zu de %zu antigos ainda validos apos reuso de slot%s\n",
+                    staleValid, handles.size() - 1, bulkOk ? "" : " DIVERGE");
+        if (!bulkOk)
+            return 2;
+    }
+    if (!tracePath.empty())
+    {
+        if (!writeTrace(tracePath))
+        {
+            std::printf("falha ao gravar %s\n", tracePath.c_str());
+            return 1;
+        }
+        std::printf("trace: %s\n", tracePath.c_str());
+    }
+
+    if (recordGolden)
+    {
+        std::ofstream goldenOut(goldenPath);
+        for (unsigned long long hash : goldenHashes)
+            goldenOut << std::hex << hash << "\n";
+        std::printf("golden: %d ticks gravados em %s\n", numTicks, goldenPath.c_str());
+    }
+    else if (!goldenPath.empty())
+    {
+        if (divergedTick >= 0)
+        {
+            std::printf("golden: DIVERGE no tick %d\n", divergedTick);
+            return 2;
+        }
+        std::printf("golden: trajetoria identica (%d ticks)\n", numTicks);
+    }
+
+    return 0;
+}
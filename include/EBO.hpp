@@ -2,12 +2,15 @@
 #define EBO_CLASS_H
 
 #include <glad/glad.h>
+#include <vector>
 
 class EBO
 {
 public:
     GLuint ID;
-    EBO(GLuint *indices, GLsizeiptr size);
+    EBO(const GLuint *indices, GLsizeiptr size);
+    // Envia direto do vetor, sem cópia intermediária
+    EBO(const std::vector<GLuint> &indices);
 
     void Bind();
     void Unbind();
@@ -11,6 +11,8 @@ public:
     VAO();
 
     void LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset);
+    // Atributo que avança uma vez por instância (glDrawElementsInstanced)
+    void LinkInstanceAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset);
     void Bind();
     void Unbind();
     void Delete();
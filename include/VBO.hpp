@@ -2,13 +2,19 @@
 #define VBO_CLASS_H
 
 #include <glad/glad.h>
+#include <vector>
 
 class VBO
 {
 public:
     GLuint ID;
-    VBO(GLfloat *vertices, GLsizeiptr size);
+    GLenum usage;
+    VBO(const GLfloat *vertices, GLsizeiptr size, GLenum usage = GL_STATIC_DRAW);
+    // Envia direto do vetor, sem cópia intermediária
+    VBO(const std::vector<GLfloat> &vertices, GLenum usage = GL_STATIC_DRAW);
 
+    // Substitui todo o conteúdo (buffers reenviados a cada frame)
+    void Update(const void *data, GLsizeiptr size);
     void Bind();
     void Unbind();
     void Delete();
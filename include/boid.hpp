@@ -2,6 +2,7 @@
 #define BOID_CLASS_H
 
 #include <glm/glm.hpp>
+#include <random>
 #include <vector>
 
 // Estrutura para representar obstáculos (árvores)
@@ -11,6 +12,14 @@ struct Tree {
     float height;  // Altura da árvore
 };
 
+// Distância (em XZ) a partir da qual os boids desviam de uma árvore
+const float OBSTACLE_DETECTION_RADIUS = 15.0f;
+
+class SpatialGrid;
+class BoidSoA;
+class FlockOctree;
+class TreeGrid;
+
 class Boid {
 public:
     glm::vec3 position;
@@ -28,22 +37,31 @@ public:
     float wingPhase;       // Fase atual [0, 2pi]
     float wingFrequency;   // Frequencia de batida
 
+    // Estado antes do último update, para interpolar a renderização entre ticks
+    glm::vec3 prevPosition;
+    glm::vec3 prevVelocity;
+    float prevWingPhase;
+
     // construtor padrao
     Boid(glm::vec3 pos, glm::vec3 vel, bool objective = false, bool alwaysPerceiveLeader = false);
 
-    // construtor vazio para aleatoriedade
-    Boid(bool objective = false, bool alwaysPerceiveLeader = false);
+    // construtor aleatório: posição, velocidade e fase das asas sorteadas de gen
+    Boid(std::mt19937& gen, bool objective = false, bool alwaysPerceiveLeader = false);
     
-    void update(std::vector<Boid> flock_list, float delta_time);
+    // Lê os vizinhos da cópia SoA do tick (nenhuma cópia por boid).
+    // Com octree, coesão e alinhamento vêm dos agregados da árvore.
+    void update(const BoidSoA& state, const SpatialGrid& grid, float delta_time, const FlockOctree* octree = nullptr);
     void applyForce(glm::vec3 force);
-    void flock(const std::vector<Boid>& boids);
+    // Percorre os vizinhos da grade uma única vez e aplica todas as regras
+    void flock(const BoidSoA& state, const SpatialGrid& grid, const FlockOctree* octree = nullptr);
     
-    // Regras dos boids
-    glm::vec3 separation(const std::vector<Boid>& boids);
-    glm::vec3 alignment(const std::vector<Boid>& boids);
-    glm::vec3 cohesion(const std::vector<Boid>& boids);
-    glm::vec3 objective(const std::vector<Boid>& boids);
-    glm::vec3 avoidObstacles(const std::vector<Tree>& trees);
+    // Regras dos boids, a partir das somas acumuladas em flock()
+    glm::vec3 separation(glm::vec3 sum, int count);
+    glm::vec3 alignment(glm::vec3 sum, int count);
+    glm::vec3 cohesion(glm::vec3 sum, int count);
+    glm::vec3 objective(glm::vec3 leaderPosition);
+    // Só consulta as árvores das células próximas da grade
+    glm::vec3 avoidObstacles(const TreeGrid& trees);
     
     // Função auxiliar para buscar um alvo
     glm::vec3 seek(glm::vec3 target);
@@ -51,8 +69,10 @@ public:
     // Manter dentro dos limites
     void edges(float boundX, float boundY, float boundZ);
     
-    // Transformação para renderização
-    glm::mat4 getModelMatrix() const;
+    // Transformação para renderização, interpolada entre o tick anterior
+    // (alpha = 0) e o atual (alpha = 1)
+    glm::mat4 getModelMatrix(float alpha = 1.0f) const;
+    float getWingPhase(float alpha = 1.0f) const;
 };
 
 #endif
@@ -0,0 +1,80 @@
+#ifndef BOID_SOA_CLASS_H
+#define BOID_SOA_CLASS_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "boid.hpp"
+
+class SpatialGrid;
+
+// Alocador com alinhamento de 32 bytes para carregar 8 floats de uma vez
+template <typename T>
+struct AlignedAllocator
+{
+    typedef T value_type;
+
+    AlignedAllocator() {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(32)));
+    }
+    void deallocate(T* p, size_t)
+    {
+        ::operator delete(p, std::align_val_t(32));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+typedef std::vector<float, AlignedAllocator<float>> AlignedFloats;
+
+// Somas acumuladas sobre os vizinhos de um boid
+struct NeighborSums
+{
+    glm::vec3 separationSum = glm::vec3(0.0f);
+    glm::vec3 velocitySum = glm::vec3(0.0f);
+    glm::vec3 positionSum = glm::vec3(0.0f);
+    int separationCount = 0;
+    int neighborCount = 0;
+};
+
+// Cópia somente leitura do estado do bando usada pelo laço de vizinhos:
+// só posição e velocidade, em arrays separados por componente (SoA) e na
+// ordem das células da grade, então cada célula é um trecho contíguo.
+// O vetor de Boid (AoS) continua sendo o estado que a renderização e a
+// câmera leem.
+class BoidSoA
+{
+public:
+    AlignedFloats px, py, pz;
+    AlignedFloats vx, vy, vz;
+
+    // Posição do líder (boid 0) no início do tick
+    glm::vec3 leaderPosition;
+
+    // Copia os boids na ordem da grade (chamar logo após grid.build)
+    void gather(const std::vector<Boid>& boids, const SpatialGrid& grid);
+
+    // Atualiza a cópia de um boid já movido (modo Gauss-Seidel)
+    void store(size_t index, glm::vec3 position, glm::vec3 velocity);
+
+    // Acumula os vizinhos nos slots [begin, end) dentro dos raios
+    void accumulate(glm::vec3 position, size_t begin, size_t end,
+                    float separationSq, float perceptionSq, NeighborSums& sums) const;
+
+    size_t size() const;
+
+private:
+    size_t count = 0;
+    std::vector<int> slotOf; // índice do boid -> posição nos arrays
+};
+
+#endif
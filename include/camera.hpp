@@ -23,6 +23,8 @@ class Camera{
         glm::vec3 Orientation = glm::vec3(0.0, 0.0, -1.0f);
         glm::vec3 Up = glm::vec3(0.0f, 1.0f, 0.0f);
         glm::mat4 cameraMatrix = glm::mat4(1.0f);
+        // Planos de cameraMatrix, atualizados junto com ela (culling)
+        Frustum frustum;
         
         glm::vec3 prevPosition;
         glm::vec3 prevOrientation = glm::vec3(0.0, 0.0, 1.0f);
@@ -42,13 +44,13 @@ class Camera{
         float sensitivity = 100.0f;
         
         // Para seguir boid
-        const Boid* targetBoid = nullptr;
         glm::vec3 followOffset = glm::vec3(0.0f, 5.0f, -15.0f);
         float followSmoothness = 0.1f;
 
         Camera(int width, int height, glm::vec3 position);
 
-        void updateMatrix(float FOVdeg, float nearPlane, float farPlane, const Flock& flock);  
+        // Segue o bando pelas estatísticas (Flock::getStats ou GpuFlock::getStats)
+        void updateMatrix(float FOVdeg, float nearPlane, float farPlane, const FlockStats& stats);  
         void Matrix(Shader& shader, const char* uniform);
         void Inputs(GLFWwindow* window, float deltaTime);
 
@@ -4,36 +4,185 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include "boid.hpp"
+#include "grid.hpp"
+#include "boidSoA.hpp"
+#include "octree.hpp"
+#include "frustum.hpp"
+#include "threadPool.hpp"
+#include <cstdint>
 #include <random>
+#include <memory>
+#ifndef BOIDS_HEADLESS
 #include <GLFW/glfw3.h> // GLFW
+#endif
+
+// Como o estado dos boids é atualizado a cada tick
+enum class UpdateMode
+{
+    Jacobi,     // todos leem a cópia do tick anterior e escrevem no vetor (ordem não importa)
+    GaussSeidel // boids seguintes já veem os anteriores movidos
+};
 
+// Referência estável a um boid. Continua apontando para o mesmo boid quando
+// outros são removidos (e o vetor é compactado) e deixa de ser válida quando
+// ele próprio é removido, mesmo que o lugar seja reaproveitado por outro.
+struct BoidHandle
+{
+    uint32_t slot = 0;
+    uint32_t generation = 0; // 0 nunca é usada: handle padrão é inválido
+
+    bool operator==(const BoidHandle &other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const BoidHandle &other) const { return !(*this == other); }
+};
+
+// Agregados do bando, calculados como subproduto do update (leitura O(1))
+struct FlockStats
+{
+    int count;
+    glm::vec3 center;       // média das posições
+    glm::vec3 meanVelocity;
+    glm::vec3 boundsMin;    // caixa que envolve todos os boids
+    glm::vec3 boundsMax;
+    float minSpeed;
+    float maxSpeed;
+    float meanSpeed;
+};
 
 class Flock
 {
 private:
     std::vector<Boid> flock_list;
+    UpdateMode updateMode;
+
+    // Handles: cada boid ocupa um slot; slots[s] diz onde o boid está em
+    // flock_list e boidSlot faz o caminho inverso. Slots livres são
+    // reaproveitados com a geração incrementada.
+    struct BoidSlot
+    {
+        uint32_t index;
+        uint32_t generation;
+    };
+    std::vector<BoidSlot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> boidSlot;
+    BoidHandle push(const Boid &b);
+    void removeAt(size_t index);
+
+    // Grade de vizinhança, reconstruída uma vez por tick
+    SpatialGrid grid;
+    // Buffer de leitura do tick: posições e velocidades em SoA na ordem da grade
+    BoidSoA state;
+
+    // Agregados de longo alcance para coesão/alinhamento (modo aproximado)
+    FlockOctree octree;
+    bool approximate;
+    float perceptionRadius;
+
+    // Threads que dividem o laço do modo Jacobi
+    std::unique_ptr<ThreadPool> pool;
+
+    // Somas das estatísticas; no modo Jacobi cada bloco do parallelFor
+    // acumula a sua e elas são juntadas na ordem dos blocos
+    struct StatsSums
+    {
+        glm::vec3 positionSum;
+        glm::vec3 velocitySum;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        float speedSum;
+        float minSpeed;
+        float maxSpeed;
+        int count;
+
+        void reset();
+        void add(const Boid &boid);
+        void merge(const StatsSums &other);
+    };
+    StatsSums statsSums;
+    std::vector<StatsSums> chunkSums;
+    FlockStats stats;
+    void refreshStats();
 
     std::mt19937 gen;
-    std::uniform_int_distribution<int> randomInt;
     bool alwaysPerceiveLeader;
 
+    // Centros interpolados (SoA) e resultado do teste de visibilidade
+    AlignedFloats cullX, cullY, cullZ;
+    std::vector<uint8_t> cullVisible;
+
 
 public:
+    // Sorteios (add, clear, spawns) usam o fluxo RandomStream::Flock da semente global
     Flock();
     
-    void add();
+    BoidHandle add();
     
-    void add(glm::vec3 position, glm::vec3 velocity);
+    BoidHandle add(glm::vec3 position, glm::vec3 velocity);
 
-    // deleta um boid aleatório
+    // Adiciona count boids aleatórios de uma vez
+    void add(int count);
+
+    // deleta um boid aleatório (nunca o líder)
     void clear();
 
+    // Remove count boids aleatórios (nunca o líder); O(count)
+    void removeRandom(int count);
+
+    // Remove o boid do handle trocando-o com o último (O(1), muda a ordem
+    // do vetor); falso se o handle já não for válido ou se for o do líder
+    // com outros boids ainda no bando
+    bool remove(BoidHandle handle);
+
+    // Boid do handle, ou nullptr se ele foi removido. O ponteiro só vale
+    // até o próximo add/remove; guarde o handle, não o ponteiro.
+    Boid *get(BoidHandle handle);
+    const Boid *get(BoidHandle handle) const;
+    bool isValid(BoidHandle handle) const;
+    // Handle do boid na posição index de getBoids()
+    BoidHandle handleAt(size_t index) const;
+
+    void reserve(size_t count);
+
     void update(float delta_time, float boundX, float boundY, float boundZ);
 
     int size() const;
 
+    // Centro, velocidade média, caixa e velocidades escalares do último update.
+    // add/clear corrigem somas e contagem na hora; a caixa e os extremos de
+    // velocidade só encolhem no próximo update.
+    const FlockStats &getStats() const;
+
+    // Índices (em getBoids()) dos boids cuja esfera de raio radius, na
+    // posição interpolada por alpha, toca o frustum. Roda em blocos no pool
+    // de threads; o resultado sai na ordem do vetor.
+    void cull(const Frustum &frustum, float alpha, float radius, std::vector<uint32_t> &visible);
+
+    // Recalcula as estatísticas do zero, depois de mudar os boids por fora
+    // (ex.: GpuFlock::download)
+    void recomputeStats();
+
+    void setUpdateMode(UpdateMode mode);
+    UpdateMode getUpdateMode() const;
+
+    // Coesão e alinhamento pela octree (Barnes-Hut) em vez de boid a boid;
+    // a grade passa a usar células do raio de separação
+    void setApproximation(bool enabled);
+    bool getApproximation() const;
+    void setOpeningAngle(float angle);
+
+    // Raio de percepção de todos os boids (e dos que forem adicionados)
+    void setPerceptionRadius(float radius);
+
+    // Quantidade de threads do update (contando a principal); 0 = todos os núcleos
+    void setThreadCount(unsigned int numThreads);
+    unsigned int getThreadCount() const;
+    // Cria os anéis de trace das threads do update antes de um trecho medido
+    void reserveTrace();
+
+#ifndef BOIDS_HEADLESS
     // inputs
     void inputs(GLFWwindow *window);
+#endif
     
     // Acessar boids para renderização
     std::vector<Boid>& getBoids();
@@ -0,0 +1,48 @@
+#ifndef FRUSTUM_CLASS_H
+#define FRUSTUM_CLASS_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// Caixa alinhada aos eixos
+struct BoundingBox
+{
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// Caixa das posições de uma malha intercalada (posição nos 3 primeiros
+// floats de cada vértice, stride floats por vértice)
+BoundingBox meshBounds(const float *vertices, size_t vertexCount, size_t stride);
+// Maior distância de um vértice à origem do modelo: esfera que envolve a
+// malha em qualquer rotação
+float meshRadius(const float *vertices, size_t vertexCount, size_t stride);
+// Caixa que envolve box transformada por model
+BoundingBox transformBounds(const BoundingBox &box, const glm::mat4 &model);
+BoundingBox mergeBounds(const BoundingBox &a, const BoundingBox &b);
+
+// Os 6 planos do volume de visão, tirados da matriz projeção * view
+// (Gribb/Hartmann). Normais para dentro e normalizadas: a distância
+// assinada de um ponto ao plano é dot(plane.xyz, p) + plane.w.
+class Frustum
+{
+public:
+    glm::vec4 planes[6];
+
+    Frustum();
+
+    void extract(const glm::mat4 &viewProjection);
+
+    // Falso só quando o volume está todo fora de algum plano (conservador)
+    bool intersectsSphere(glm::vec3 center, float radius) const;
+    bool intersectsBox(const BoundingBox &box) const;
+
+    // Teste de count esferas de mesmo raio com centros em arrays SoA:
+    // visible[i] = 1 se a esfera i pode aparecer. Sem desvios por esfera,
+    // 8 (AVX) ou 4 (SSE2) por instrução.
+    void cullSpheres(const float *x, const float *y, const float *z, float radius,
+                     size_t count, uint8_t *visible) const;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef GL_COMPUTE_H
+#define GL_COMPUTE_H
+
+#include <glad/glad.h>
+
+// O glad do projeto foi gerado para OpenGL 3.3. As poucas funções e
+// constantes do 4.3 usadas pelos compute shaders são carregadas aqui, à
+// parte, com o mesmo carregador (glfwGetProcAddress, eglGetProcAddress...).
+#ifndef GL_VERSION_4_3
+#define GL_COMPUTE_SHADER 0x91B9
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+
+typedef void (APIENTRYP PFNGLDISPATCHCOMPUTEPROC)(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+typedef void (APIENTRYP PFNGLMEMORYBARRIERPROC)(GLbitfield barriers);
+
+extern PFNGLDISPATCHCOMPUTEPROC glad_glDispatchCompute;
+extern PFNGLMEMORYBARRIERPROC glad_glMemoryBarrier;
+#define glDispatchCompute glad_glDispatchCompute
+#define glMemoryBarrier glad_glMemoryBarrier
+#endif
+
+// Desenho indireto (4.0): a contagem de instâncias visíveis é escrita pelo
+// compute shader e nunca volta para a CPU
+#ifndef GL_VERSION_4_0
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+
+typedef void (APIENTRYP PFNGLDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void *indirect);
+
+extern PFNGLDRAWELEMENTSINDIRECTPROC glad_glDrawElementsIndirect;
+#define glDrawElementsIndirect glad_glDrawElementsIndirect
+#endif
+
+// Carrega as funções acima; falso se o contexto atual não for 4.3 ou mais
+// novo (a simulação na GPU fica indisponível e tudo roda na CPU)
+bool loadComputeFunctions(GLADloadproc load);
+bool computeFunctionsLoaded();
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef GPU_FLOCK_CLASS_H
+#define GPU_FLOCK_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "flock.hpp"
+#include "frustum.hpp"
+#include "lod.hpp"
+#include "shaderClass.hpp"
+#include "VBO.hpp"
+
+// Floats por boid no buffer de instâncias: mat4 + fase das asas (BoidInstance)
+const int GPU_INSTANCE_FLOATS = 17;
+// Cópias das estatísticas em trânsito para a CPU (uma por update recente)
+const int GPU_STATS_READBACKS = 3;
+
+// Estado de um boid nos shader storage buffers (layout std430 de flock.comp)
+struct GpuBoid
+{
+    glm::vec4 position;     // xyz, w = fase das asas
+    glm::vec4 velocity;     // xyz, w = velocidade máxima
+    glm::vec4 prevPosition; // xyz, w = fase antes do último tick
+    glm::vec4 prevVelocity; // xyz, w = raio de percepção
+    glm::vec4 params;       // força máxima, frequência das asas, é líder, sempre percebe o líder
+};
+
+// Simulação do bando em compute shaders (GL 4.3). Os boids ficam em dois
+// SSBOs que se alternam a cada tick (Jacobi): grade, regras, obstáculos e
+// bordas rodam na GPU, e o buffer de instâncias do desenho é preenchido lá
+// mesmo, sem passar pela CPU. A ordem dos boids é a mesma do Flock, então
+// upload/download preservam índices e handles. O modo aproximado (octree) e o
+// Gauss-Seidel só existem na CPU.
+class GpuFlock
+{
+public:
+    GpuFlock();
+
+    // Compila flock.comp e cria os buffers; falso sem GL 4.3 (chamar
+    // loadComputeFunctions antes) ou se o shader não compilar
+    bool init(const char *computeFile);
+    bool isReady() const;
+    void Delete();
+
+    // Copia o estado completo do Flock (e as árvores) para a GPU
+    void upload(const Flock &flock);
+    // Traz o estado de volta; boids precisa ter o mesmo tamanho do upload
+    void download(std::vector<Boid> &boids);
+    void download(Flock &flock);
+
+    // Um tick com passo deltaTime dentro dos limites dados
+    void update(float deltaTime, float boundX, float boundY, float boundZ);
+
+    // Preenche instances com GPU_INSTANCE_FLOATS floats por boid,
+    // interpolando entre os dois últimos ticks
+    void writeInstances(VBO &instances, float alpha, bool wingAnimation);
+    // Idem, agrupando os boids pelo nível de detalhe de lod (esfera de raio
+    // radius): o nível l ocupa as instâncias [l * size(), (l + 1) * size()),
+    // compactadas em ordem qualquer, e a contagem vai para o comando l de
+    // drawIndirect, que desenha indexCounts[l] índices por instância. Com
+    // frustum, só entram os boids cuja esfera toca o volume.
+    void writeVisibleInstances(VBO &instances, float alpha, bool wingAnimation, const Frustum *frustum,
+                               float radius, const LodSelector &lod, const GLuint indexCounts[LOD_LEVELS]);
+    // glDrawElementsIndirect com o comando do nível level do último
+    // writeVisibleInstances (VAO e shader do desenho já ativos; o VAO lê as
+    // instâncias desde o início do buffer, o comando já traz o deslocamento)
+    void drawIndirect(int level, GLenum mode = GL_TRIANGLES);
+    // Instâncias do último writeVisibleInstances (todas ou só as do nível
+    // level); espera a GPU, serve para conferência e não para o laço de desenho
+    GLuint readVisibleCount(int level = -1);
+
+    // Estatísticas da cópia mais recente que a GPU já terminou (em geral do
+    // quadro anterior): não espera a GPU, então servem para a câmera. Até a
+    // primeira cópia ficar pronta valem as do Flock enviado no upload.
+    const FlockStats &getStats();
+    // Estatísticas do último update; espera a GPU, serve para conferência
+    FlockStats readStats();
+
+    int size() const;
+
+private:
+    enum Pass
+    {
+        PassClear = 0,
+        PassCount = 1,
+        PassScan = 2,
+        PassScatter = 3,
+        PassStep = 4,
+        PassStats = 5,
+        PassInstances = 6
+    };
+
+    void dispatch(Pass pass, GLuint numItems);
+    void dispatchInstances(VBO &instances, size_t count, float alpha, bool wingAnimation);
+    void uploadTrees();
+    void queueStatsReadback();
+    void resizeGrid(size_t numCells);
+
+    std::unique_ptr<Shader> program;
+    GLuint boidBuffers[2];
+    int current; // buffer com o estado atual
+    GLuint gridBuffer;
+    GLuint sortedBuffer;
+    GLuint treeBuffer;
+    GLuint treeCellBuffer;
+    GLuint statsBuffer;
+    GLuint drawCommandBuffer;
+
+    size_t numBoids;
+    size_t gridCells;
+    float cellSize;
+    size_t numTrees;
+    FlockStats stats;
+    // Anel de cópias do statsBuffer, cada uma com a cerca do seu update
+    GLuint statsReadbacks[GPU_STATS_READBACKS];
+    GLsync statsFences[GPU_STATS_READBACKS];
+    int nextReadback;
+    std::vector<GpuBoid> staging;
+
+    // Localizações dos uniforms, resolvidas uma vez
+    GLint passLoc, numBoidsLoc, numCellsLoc, gridOriginLoc, gridInvCellSizeLoc, gridDimsLoc;
+    GLint boundsLoc, deltaTimeLoc, treeOriginLoc, treeInvCellSizeLoc, treeDimsLoc, numTreesLoc;
+    GLint alphaLoc, wingAnimationLoc, indirectLoc, cullEnabledLoc, frustumPlanesLoc, cullRadiusLoc;
+    GLint lodCameraLoc, lodDistanceSqLoc;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef GRID_CLASS_H
+#define GRID_CLASS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "boid.hpp"
+
+// Grade uniforme fixa sobre os limites do mundo para buscar vizinhos.
+// Os boids são ordenados por célula (counting sort), então cada célula vira
+// um intervalo contíguo em sortedIndices. Com cellSize >= raio de percepção,
+// todo vizinho de um boid está na célula dele ou em uma das 26 adjacentes.
+class SpatialGrid
+{
+public:
+    SpatialGrid();
+
+    // Reconstroi a grade com as posições atuais (uma vez por tick)
+    void build(const std::vector<Boid>& boids, glm::vec3 minBound, glm::vec3 maxBound, float cellSize);
+
+    // Chama func(begin, end) para cada trecho de sortedIndices que cobre
+    // as células vizinhas de position (no máximo 9 trechos)
+    template <typename Func>
+    void forEachNeighborRange(glm::vec3 position, Func func) const;
+
+    // Índices dos boids na ordem das células
+    const std::vector<int>& order() const;
+
+private:
+    glm::ivec3 cellOf(glm::vec3 position) const;
+    int cellIndex(int x, int y, int z) const;
+
+    glm::vec3 origin;
+    float invCellSize;
+    glm::ivec3 dims;
+
+    std::vector<int> cellStart;     // início de cada célula em sortedIndices (numCells + 1)
+    std::vector<int> cellCursor;    // cursor de escrita usado no counting sort
+    std::vector<int> boidCell;      // célula de cada boid
+    std::vector<int> sortedIndices; // índices dos boids agrupados por célula
+};
+
+inline glm::ivec3 SpatialGrid::cellOf(glm::vec3 position) const
+{
+    // Posições fora dos limites caem na célula da borda; como o clamp não
+    // aumenta distâncias entre células, a vizinhança continua correta
+    glm::ivec3 cell = glm::ivec3(glm::floor((position - origin) * invCellSize));
+    return glm::clamp(cell, glm::ivec3(0), dims - 1);
+}
+
+inline int SpatialGrid::cellIndex(int x, int y, int z) const
+{
+    return x + dims.x * (y + dims.y * z);
+}
+
+inline const std::vector<int>& SpatialGrid::order() const
+{
+    return sortedIndices;
+}
+
+template <typename Func>
+void SpatialGrid::forEachNeighborRange(glm::vec3 position, Func func) const
+{
+    if (sortedIndices.empty())
+        return;
+
+    glm::ivec3 c = cellOf(position);
+    int x0 = glm::max(c.x - 1, 0);
+    int x1 = glm::min(c.x + 1, dims.x - 1);
+
+    for (int z = glm::max(c.z - 1, 0); z <= glm::min(c.z + 1, dims.z - 1); z++)
+    {
+        for (int y = glm::max(c.y - 1, 0); y <= glm::min(c.y + 1, dims.y - 1); y++)
+        {
+            // As células em x são consecutivas, então as três formam um único intervalo
+            int begin = cellStart[cellIndex(x0, y, z)];
+            int end = cellStart[cellIndex(x1, y, z) + 1];
+            if (begin < end)
+                func(begin, end);
+        }
+    }
+}
+
+#endif
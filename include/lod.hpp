@@ -0,0 +1,55 @@
+#ifndef LOD_CLASS_H
+#define LOD_CLASS_H
+
+#include <glm/glm.hpp>
+
+// Níveis de detalhe: 0 é a malha original, 1 e 2 são versões
+// simplificadas e o último é o impostor (um ponto só). Malhas sem impostor
+// (árvores, fusca) param no nível LOD_IMPOSTOR - 1.
+const int LOD_LEVELS = 4;
+const int LOD_IMPOSTOR = LOD_LEVELS - 1;
+
+// Distâncias ao quadrado em que um objeto de um raio fixo passa para cada
+// nível seguinte; calculadas uma vez por quadro e por raio
+struct LodRanges
+{
+    float distanceSq[LOD_LEVELS - 1];
+
+    // Nível para um objeto a distância² d2 da câmera (sem desvios: os limites
+    // são crescentes, então basta contar quantos foram ultrapassados)
+    int select(float d2) const
+    {
+        int level = 0;
+        for (int l = 0; l < LOD_LEVELS - 1; l++)
+            level += d2 > distanceSq[l] ? 1 : 0;
+        return level;
+    }
+};
+
+// Escolhe o nível pelo tamanho projetado na tela: uma esfera de raio r a
+// distância d ocupa cerca de 2r * pixelsPerUnit / d pixels de altura. Cada
+// nível vale enquanto esse diâmetro estiver acima do seu limite em pixels.
+class LodSelector
+{
+public:
+    // Diâmetro na tela (pixels) abaixo do qual cada nível cede ao próximo
+    float pixelThresholds[LOD_LEVELS - 1];
+    // Desligado, tudo fica no nível 0 (tecla L, para comparar)
+    bool enabled;
+
+    LodSelector();
+
+    // Posição da câmera e escala da projeção do quadro atual
+    void update(const glm::vec3 &cameraPosition, float fovDegrees, int viewportHeight);
+
+    LodRanges ranges(float radius) const;
+    int select(const glm::vec3 &center, float radius) const;
+
+    const glm::vec3 &getCameraPosition() const;
+
+private:
+    glm::vec3 cameraPosition;
+    float pixelsPerUnit;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef MESH_CLASS_H
+#define MESH_CLASS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Floats por vértice em todas as malhas: posição (3), cor (3), textura (2), normal (3)
+const int MESH_FLOATS_PER_VERTEX = 11;
+
+// Malha pronta para o VBO/EBO. Os dados ficam em vetores próprios (OBJ
+// recém lido) ou em um arquivo .mesh mapeado em memória, sem cópia.
+class Mesh
+{
+public:
+    Mesh();
+    ~Mesh();
+    Mesh(Mesh &&other) noexcept;
+    Mesh &operator=(Mesh &&other) noexcept;
+    Mesh(const Mesh &) = delete;
+    Mesh &operator=(const Mesh &) = delete;
+
+    const float *vertices() const;
+    const uint32_t *indices() const;
+    size_t vertexCount() const;
+    size_t indexCount() const;
+    size_t vertexBytes() const;
+    size_t indexBytes() const;
+
+    // Verdadeiro quando os dados vêm do cache binário mapeado
+    bool isMapped() const;
+
+    // Preenche a partir de vetores (assume a posse deles)
+    void assign(std::vector<float> &&vertexData, std::vector<uint32_t> &&indexData);
+    // Mapeia um arquivo .mesh; falso se não existir ou não bater com a fonte
+    bool mapCache(const std::string &cachePath, uint64_t sourceSize, int64_t sourceTime, const float color[3], bool optimized);
+
+private:
+    void unmap();
+
+    std::vector<float> ownedVertices;
+    std::vector<uint32_t> ownedIndices;
+
+    const float *vertexPtr = nullptr;
+    const uint32_t *indexPtr = nullptr;
+    size_t numVertices = 0;
+    size_t numIndices = 0;
+
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+#ifdef _WIN32
+    void *mappingHandle = nullptr;
+#endif
+};
+
+// Lê um OBJ em texto: vértices intercalados (11 floats) com a cor fixa r, g, b.
+// Cantos de face com a mesma tripla (v, vt, vn) compartilham um único vértice.
+bool objLoader(std::vector<float> &v, std::vector<uint32_t> &e, const std::string &path, float r = 0.3f, float g = 0.2f, float b = 0.1f);
+
+// Reordena os triângulos para reaproveitar o cache de vértices da GPU (Forsyth)
+void optimizeVertexCache(std::vector<uint32_t> &e, size_t vertexCount);
+// Renumera os vértices na ordem do primeiro uso pelos índices
+void reorderVertices(std::vector<float> &v, std::vector<uint32_t> &e);
+// Simplifica por agrupamento de vértices (Rossignac-Borrel): a caixa da malha
+// vira uma grade com resolution células no maior eixo, os vértices de cada
+// célula se fundem na média e os triângulos degenerados somem
+void decimateMesh(const float *v, size_t vertexCount, const uint32_t *e, size_t indexCount, int resolution,
+                  std::vector<float> &outV, std::vector<uint32_t> &outE);
+// Impostor para desenho com GL_POINTS: um vértice na origem com a cor média
+void impostorMesh(const float *v, size_t vertexCount, std::vector<float> &outV, std::vector<uint32_t> &outE);
+// Faltas de cache FIFO por triângulo (3.0 = nenhum reaproveitamento)
+float averageCacheMissRatio(const std::vector<uint32_t> &e, size_t vertexCount, int cacheSize = 32);
+
+// Carrega path pelo cache binário (path + ".mesh") quando ele é mais novo que
+// o OBJ; caso contrário lê o OBJ, otimiza a ordem dos índices (optimize) e
+// regrava o cache para a próxima execução
+Mesh loadMesh(const std::string &path, float r = 0.3f, float g = 0.2f, float b = 0.1f, bool optimize = true);
+
+#endif
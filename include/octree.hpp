@@ -0,0 +1,56 @@
+#ifndef OCTREE_CLASS_H
+#define OCTREE_CLASS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "boidSoA.hpp"
+
+// Octree sobre a cópia SoA do tick para coesão e alinhamento de longo alcance.
+// Cada nó guarda quantidade, soma das posições e soma das velocidades dos boids
+// dentro dele. Na consulta, nós pequenos vistos de longe (critério de abertura
+// de Barnes-Hut) entram pelo agregado em vez de boid a boid, então o custo
+// cresce com log N e não com o número de vizinhos dentro do raio.
+class FlockOctree
+{
+public:
+    FlockOctree();
+
+    // Reconstroi a árvore com as posições e velocidades do tick
+    void build(const BoidSoA& state);
+
+    // Razão tamanho do nó / distância ao centro de massa abaixo da qual o nó
+    // é aproximado. Limitado a 0.5 para que o nó que contém o próprio boid
+    // seja sempre aberto e ele entre na soma exatamente uma vez.
+    void setOpeningAngle(float angle);
+    float getOpeningAngle() const;
+
+    // Soma em sums.neighborCount / positionSum / velocitySum todos os boids a
+    // menos de radius de position, incluindo o próprio boid (quem chama desconta)
+    void accumulate(glm::vec3 position, float radius, NeighborSums& sums) const;
+
+private:
+    struct Node
+    {
+        glm::vec3 center;
+        float halfSize;
+        glm::vec3 positionSum;
+        glm::vec3 velocitySum;
+        int count;
+        int firstChild; // 8 filhos consecutivos em nodes; -1 = folha
+        int begin;      // trecho de items coberto pelo nó
+        int end;
+    };
+
+    void buildNode(int nodeIndex, int depth);
+
+    std::vector<Node> nodes;
+    std::vector<int> items;             // slots da SoA na ordem da árvore
+    std::vector<int> scratch;           // buffer da partição em octantes
+    std::vector<glm::vec3> positions;   // cópia do tick por slot (usada na construção)
+    std::vector<glm::vec3> velocities;
+    std::vector<glm::vec3> leafPositions;   // mesma cópia na ordem da árvore, lida nas folhas
+    std::vector<glm::vec3> leafVelocities;
+    float openingAngle;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef PROFILER_CLASS_H
+#define PROFILER_CLASS_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <chrono>
+#include <fstream>
+#include <string>
+
+// Trechos medidos a cada quadro (ordem das linhas do overlay e das colunas do CSV)
+enum class ProfileSection
+{
+    Input,      // teclado, câmera livre, edições do bando
+    Simulation, // ticks do passo fixo (CPU ou compute shaders)
+    Camera,     // Camera::updateMatrix
+    Terrain,
+    Boids,      // instâncias + desenho
+    Trees,
+    Fusca,
+    Light,
+    Overlay,
+    Swap,       // glfwSwapBuffers + eventos (inclui a espera do vsync)
+    Count
+};
+
+const int PROFILE_SECTION_COUNT = (int)ProfileSection::Count;
+// Quadros guardados para médias e percentis
+const int PROFILER_HISTORY = 240;
+// Quadros em voo das queries da GPU: o resultado de um quadro só é lido
+// PROFILER_QUERY_FRAMES quadros depois, quando já está pronto
+const int PROFILER_QUERY_FRAMES = 4;
+
+// Média e percentis em ms sobre o histórico
+struct ProfileStats
+{
+    float average;
+    float p50;
+    float p95;
+    float p99;
+    int samples;
+};
+
+// Perfil por quadro: tempos de CPU com steady_clock e de GPU com queries
+// GL_TIME_ELAPSED (core desde o 3.3) em anel, lidas sem bloquear. Com o
+// rastreamento ligado (trace.hpp) o quadro e cada trecho viram zonas.
+class FrameProfiler
+{
+public:
+    FrameProfiler();
+
+    // Cria as queries (precisa do contexto OpenGL)
+    void init();
+    void Delete();
+
+    void beginFrame();
+    void endFrame();
+
+    // gpu = true também mede o trecho na GPU; só um trecho de GPU pode
+    // estar aberto por vez (queries de tempo não aninham)
+    void begin(ProfileSection section, bool gpu = false);
+    void end(ProfileSection section);
+
+    // Grava uma linha por quadro assim que os tempos de GPU dele chegam
+    bool openCsv(const std::string &path);
+
+    ProfileStats frameStats() const;
+    ProfileStats cpuStats(ProfileSection section) const;
+    ProfileStats gpuStats(ProfileSection section) const;
+
+    // Tabela de texto com médias e percentis (para o overlay)
+    std::string report() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct History
+    {
+        float samples[PROFILER_HISTORY];
+        int count = 0;
+        int next = 0;
+
+        void push(float value);
+        ProfileStats stats() const;
+    };
+
+    // Quadro ainda esperando os resultados da GPU
+    struct PendingFrame
+    {
+        long long frame = -1;
+        float frameMs = 0.0f;
+        float cpuMs[PROFILE_SECTION_COUNT];
+        bool gpuIssued[PROFILE_SECTION_COUNT];
+    };
+
+    void resolve(PendingFrame &pending, int slot);
+
+    History frameHistory;
+    History cpuHistory[PROFILE_SECTION_COUNT];
+    History gpuHistory[PROFILE_SECTION_COUNT];
+
+    GLuint queries[PROFILER_QUERY_FRAMES][PROFILE_SECTION_COUNT];
+    PendingFrame pending[PROFILER_QUERY_FRAMES];
+    bool initialized;
+    long long frameIndex;
+    long long droppedFrames; // resultados da GPU que não chegaram a tempo
+
+    Clock::time_point frameStart;
+    Clock::time_point sectionStart[PROFILE_SECTION_COUNT];
+    // Início das zonas do trace; 0 = rastreamento estava desligado no begin
+    uint64_t traceFrameStart;
+    uint64_t traceSectionStart[PROFILE_SECTION_COUNT];
+
+    std::ofstream csv;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <random>
+
+// Semente global da simulação. Cada parte que sorteia valores tem o próprio
+// fluxo derivado dela, então a mesma semente reproduz exatamente a mesma
+// execução e sortear mais em um fluxo não muda os outros.
+enum class RandomStream : unsigned int
+{
+    Flock = 1,  // Flock::add, Flock::clear e spawns pelo teclado
+    Trees = 2,  // posição e tamanho das árvores
+    Floor = 3   // alturas do terreno
+};
+
+void setGlobalSeed(unsigned int seed);
+unsigned int getGlobalSeed();
+
+// Gerador novo para o fluxo, derivado da semente global atual
+std::mt19937 makeRandomStream(RandomStream stream);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <vector>
+#include "boid.hpp"
+#include "treeGrid.hpp"
+
+// Árvores da cena, lidas pela renderização, e a grade usada pelos boids
+// para desviar delas
+extern std::vector<Tree> globalTrees;
+extern TreeGrid globalTreeGrid;
+
+// Quantidade de árvores da cena original (mais a árvore central)
+const int DEFAULT_TREE_COUNT = 15;
+const float DEFAULT_TREE_AREA = 500.0f;
+
+// Sorteia numTrees árvores em [-area, area] no plano XZ (fluxo
+// RandomStream::Trees), acrescenta a árvore central e monta a grade
+void placeTrees(int numTrees = DEFAULT_TREE_COUNT, float area = DEFAULT_TREE_AREA);
+
+#endif
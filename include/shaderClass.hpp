@@ -2,7 +2,9 @@
 #define SHADER_CLASS_H
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 #include <string>
+#include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -15,12 +17,38 @@ class Shader
 public:
     GLuint ID;
     Shader(const char *vertexFile, const char *fragmentFile);
+    // Programa com um único compute shader (precisa de GL 4.3, ver glCompute.hpp)
+    explicit Shader(const char *computeFile);
 
     void Activate();
     void Delete();
 
+    // Location of a uniform; all active uniforms are cached at link time,
+    // so this never calls glGetUniformLocation for them again
+    GLint GetUniformLocation(const char *name);
+
+    // Typed setters (the shader must be active). Hot loops should fetch the
+    // location once and use the GLint overloads to skip the name lookup.
+    void SetInt(GLint location, GLint value);
+    void SetFloat(GLint location, GLfloat value);
+    void SetVec2(GLint location, const glm::vec2 &value);
+    void SetVec3(GLint location, const glm::vec3 &value);
+    void SetVec4(GLint location, const glm::vec4 &value);
+    void SetMat4(GLint location, const glm::mat4 &value);
+
+    void SetInt(const char *name, GLint value);
+    void SetFloat(const char *name, GLfloat value);
+    void SetVec2(const char *name, const glm::vec2 &value);
+    void SetVec3(const char *name, const glm::vec3 &value);
+    void SetVec4(const char *name, const glm::vec4 &value);
+    void SetMat4(const char *name, const glm::mat4 &value);
+
 private:
+    std::unordered_map<std::string, GLint> uniformLocations;
+
     // Checks if the different Shaders have compiled properly
     void compileErrors(unsigned int shader, const char *type);
+    // Fills uniformLocations with every active uniform of the linked program
+    void cacheUniformLocations();
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef TEXT_OVERLAY_CLASS_H
+#define TEXT_OVERLAY_CLASS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include "shaderClass.hpp"
+#include "VAO.hpp"
+#include "VBO.hpp"
+
+// Texto na tela com uma fonte bitmap 5x7 embutida (maiúsculas, dígitos e
+// pontuação básica), sem textura: cada pixel aceso vira um quadrado. Pensado
+// para poucas linhas que mudam algumas vezes por segundo (overlay do perfil).
+class TextOverlay
+{
+public:
+    TextOverlay(const char *vertexFile, const char *fragmentFile);
+
+    // Reconstroi a geometria; letras minúsculas viram maiúsculas e caracteres
+    // fora da fonte viram espaço
+    void SetText(const std::string &text);
+    // Desenha no canto superior esquerdo sobre um fundo escuro
+    void Draw(int screenWidth, int screenHeight);
+    void Delete();
+
+    // Tamanho em pixels da tela de cada pixel da fonte
+    int scale = 2;
+
+private:
+    void pushQuad(float x, float y, float width, float height);
+
+    Shader shader;
+    VAO vao;
+    VBO vbo;
+    std::vector<GLfloat> vertices; // 2 floats por vértice, 6 vértices por quadrado
+    GLsizei textVertexCount = 0;   // os 6 primeiros vértices são o fundo
+};
+
+#endif
@@ -6,12 +6,32 @@
 
 #include"shaderClass.hpp"
 
+// Decoded image in CPU memory, ready for glTexImage2D. Decoding needs no GL
+// context, so it can run on a worker thread.
+struct ImageData
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	unsigned char* bytes = nullptr;
+
+	ImageData() {}
+	explicit ImageData(const char* image);
+	~ImageData();
+	ImageData(ImageData&& other) noexcept;
+	ImageData& operator=(ImageData&& other) noexcept;
+	ImageData(const ImageData&) = delete;
+	ImageData& operator=(const ImageData&) = delete;
+};
+
 class Texture
 {
 public:
 	GLuint ID;
 	GLenum type;
 	Texture(const char* image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType);
+	// Uploads an image that was already decoded
+	Texture(const ImageData& image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType);
 
 	// Assigns a texture unit to a texture
 	void texUnit(Shader& shader, const char* uniform, GLuint unit);
@@ -0,0 +1,71 @@
+#ifndef THREAD_POOL_CLASS_H
+#define THREAD_POOL_CLASS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads persistente para laços paralelos.
+// As threads ficam dormindo entre os ticks; parallelFor divide o intervalo
+// em blocos que cada thread (inclusive a que chamou) pega de um contador
+// atômico, então threads mais rápidas acabam pegando mais blocos.
+class ThreadPool
+{
+public:
+    // numThreads conta a thread que chama parallelFor; 0 usa todos os núcleos
+    explicit ThreadPool(unsigned int numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int size() const;
+
+    // Executa func(begin, end) sobre [0, count) em blocos de até grain itens
+    // e só retorna quando todos os blocos terminarem. Não aloca memória.
+    template <typename Func>
+    void parallelFor(size_t count, size_t grain, Func& func);
+
+    // Cria o anel de trace de cada thread do pool e da que chama (todas
+    // acordam e chamam traceReserveThread), para que as zonas de um trecho
+    // medido não aloquem
+    void reserveTrace();
+
+private:
+    typedef void (*ChunkFunc)(void* context, size_t begin, size_t end);
+
+    void run(ChunkFunc func, void* context, size_t count, size_t grain);
+    void runChunks();
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    unsigned long long generation;
+    unsigned int pendingWorkers;
+    bool stopping;
+    bool reservingTrace;
+
+    // Trabalho atual
+    ChunkFunc jobFunc;
+    void* jobContext;
+    size_t jobCount;
+    size_t jobGrain;
+    std::atomic<size_t> nextIndex;
+};
+
+template <typename Func>
+void ThreadPool::parallelFor(size_t count, size_t grain, Func& func)
+{
+    ChunkFunc trampoline = [](void* context, size_t begin, size_t end)
+    {
+        (*static_cast<Func*>(context))(begin, end);
+    };
+    run(trampoline, &func, count, grain);
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef TRACE_CLASS_H
+#define TRACE_CLASS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Rastreamento por zonas para inspeção offline no chrome://tracing ou no
+// Perfetto. Cada thread grava o início e a duração das suas zonas num anel
+// próprio (sem trava nem alocação por evento); writeTrace junta os anéis num
+// JSON "Trace Event Format". Desligado, uma zona custa uma leitura atômica.
+// Compilar com -DBOIDS_NO_TRACE remove as zonas por completo.
+
+// Eventos guardados por thread; os mais antigos são sobrescritos
+const uint32_t TRACE_BUFFER_EVENTS = 1u << 16;
+
+extern std::atomic<bool> traceEnabledFlag;
+
+inline bool tracingEnabled()
+{
+    return traceEnabledFlag.load(std::memory_order_relaxed);
+}
+
+void setTracingEnabled(bool enabled);
+
+// Nome da thread no trace (ponteiro guardado, deve ser uma string estática)
+void setTraceThreadName(const char *name);
+
+// Cria já o anel da thread atual, que senão nasce na primeira zona. Serve
+// para trechos medidos que não podem alocar (ThreadPool::reserveTrace).
+void traceReserveThread();
+
+// Grava os eventos ainda nos anéis em path. Deve ser chamada com as outras
+// threads fora de zonas (entre quadros, ou com o pool parado), senão pode
+// ler um evento pela metade.
+bool writeTrace(const std::string &path);
+
+// Nanossegundos desde o início do processo (relógio dos eventos)
+uint64_t traceNow();
+
+// Grava um evento já medido na thread atual (para trechos que não cabem
+// num escopo, como as seções do FrameProfiler)
+void traceRecord(const char *name, uint64_t start, uint64_t end);
+
+// Zona do construtor ao destrutor; name deve ser uma string estática
+class TraceZone
+{
+public:
+    explicit TraceZone(const char *name)
+        : name(tracingEnabled() ? name : nullptr), start(this->name ? traceNow() : 0)
+    {
+    }
+
+    ~TraceZone()
+    {
+        if (name)
+            traceRecord(name, start, traceNow());
+    }
+
+    TraceZone(const TraceZone &) = delete;
+    TraceZone &operator=(const TraceZone &) = delete;
+
+private:
+    const char *name;
+    uint64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef BOIDS_NO_TRACE
+#define TRACE_ZONE(name)
+#else
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+#endif
+
+#endif
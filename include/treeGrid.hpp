@@ -0,0 +1,103 @@
+#ifndef TREE_GRID_CLASS_H
+#define TREE_GRID_CLASS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "boid.hpp"
+
+// Grade 2D (XZ) fixa sobre as árvores, montada uma vez quando elas são
+// posicionadas. As árvores são copiadas na ordem das células (counting sort),
+// então cada linha de células em x vira um trecho contíguo de sortedTrees.
+class TreeGrid
+{
+public:
+    TreeGrid();
+
+    // Reconstroi a grade com as árvores atuais; cellSize deve ser da ordem
+    // do raio das consultas
+    void build(const std::vector<Tree>& trees, float cellSize);
+
+    // Chama func(tree) para as árvores das células que cobrem o quadrado de
+    // lado 2 * radius em torno de position (em XZ); quem chama filtra a distância
+    template <typename Func>
+    void forEachNear(glm::vec3 position, float radius, Func func) const;
+
+    size_t size() const;
+
+    // Dados crus da grade, para enviar à GPU (GpuFlock)
+    const std::vector<int>& cellStarts() const;
+    const std::vector<Tree>& trees() const;
+    glm::vec2 getOrigin() const;
+    float getInvCellSize() const;
+    glm::ivec2 getDims() const;
+
+private:
+    glm::ivec2 cellOf(glm::vec2 positionXZ) const;
+
+    glm::vec2 origin;
+    float invCellSize;
+    glm::ivec2 dims;
+
+    std::vector<int> cellStart;    // início de cada célula em sortedTrees (numCells + 1)
+    std::vector<Tree> sortedTrees; // cópia das árvores agrupada por célula
+};
+
+inline glm::ivec2 TreeGrid::cellOf(glm::vec2 positionXZ) const
+{
+    glm::ivec2 cell = glm::ivec2(glm::floor((positionXZ - origin) * invCellSize));
+    return glm::clamp(cell, glm::ivec2(0), dims - 1);
+}
+
+inline size_t TreeGrid::size() const
+{
+    return sortedTrees.size();
+}
+
+inline const std::vector<int>& TreeGrid::cellStarts() const
+{
+    return cellStart;
+}
+
+inline const std::vector<Tree>& TreeGrid::trees() const
+{
+    return sortedTrees;
+}
+
+inline glm::vec2 TreeGrid::getOrigin() const
+{
+    return origin;
+}
+
+inline float TreeGrid::getInvCellSize() const
+{
+    return invCellSize;
+}
+
+inline glm::ivec2 TreeGrid::getDims() const
+{
+    return dims;
+}
+
+template <typename Func>
+void TreeGrid::forEachNear(glm::vec3 position, float radius, Func func) const
+{
+    if (sortedTrees.empty())
+        return;
+
+    // Fora dos limites o clamp leva à célula da borda, que ainda contém
+    // toda árvore a menos de radius
+    glm::vec2 positionXZ(position.x, position.z);
+    glm::ivec2 first = cellOf(positionXZ - radius);
+    glm::ivec2 last = cellOf(positionXZ + radius);
+
+    for (int z = first.y; z <= last.y; z++)
+    {
+        // Células vizinhas em x são consecutivas: um trecho por linha
+        int begin = cellStart[first.x + dims.x * z];
+        int end = cellStart[last.x + dims.x * z + 1];
+        for (int i = begin; i < end; i++)
+            func(sortedTrees[i]);
+    }
+}
+
+#endif
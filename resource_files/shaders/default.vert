@@ -3,6 +3,9 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec2 aTex;
 layout (location = 3) in vec3 aNormal;
+// Dados por instância (boids desenhados em uma única chamada)
+layout (location = 4) in mat4 aInstanceModel; // ocupa as locations 4 a 7
+layout (location = 8) in float aInstanceWingPhase;
 
 out vec3 color;
 out vec2 texCoord;
@@ -13,24 +16,29 @@ uniform float time;
 uniform float wingPhase;
 uniform mat4 camMatrix;
 uniform mat4 model;
+uniform bool instanced;
 
 void main()
 {
+   // Instâncias trazem a própria matriz e fase; o resto usa os uniforms
+   mat4 modelMatrix = instanced ? aInstanceModel : model;
+   float phase = instanced ? aInstanceWingPhase : wingPhase;
+
    // Aplicar animação das asas
    vec3 pos = aPos;
    
    // Se é um vértice de asa
    if (abs(pos.x) > 4.0) {
-       float wingOffset = sin(wingPhase) * 1.5;  // Amplitude: +-1.5 unidades (movimento maior)
+       float wingOffset = sin(phase) * 1.5;  // Amplitude: +-1.5 unidades (movimento maior)
        pos.y += wingOffset;
    }
    
    // operações para renderizar em 3d
-   FragPos = vec3(model * vec4(pos, 1.0));
+   FragPos = vec3(modelMatrix * vec4(pos, 1.0));
    gl_Position = camMatrix * vec4(FragPos, 1.0);
    
    // Transformar normal para world space
-   Normal = mat3(transpose(inverse(model))) * aNormal;
+   Normal = mat3(transpose(inverse(modelMatrix))) * aNormal;
 
    color = aColor;
    texCoord = aTex;
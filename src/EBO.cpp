@@ -1,6 +1,6 @@
 #include "EBO.hpp"
 
-EBO::EBO(GLuint *indices, GLsizeiptr size)
+EBO::EBO(const GLuint *indices, GLsizeiptr size)
 {
     glGenBuffers(1, &ID);
     // armazena os indices no buffer.
@@ -9,6 +9,11 @@ EBO::EBO(GLuint *indices, GLsizeiptr size)
 
 }
 
+EBO::EBO(const std::vector<GLuint> &indices)
+    : EBO(indices.data(), indices.size() * sizeof(GLuint))
+{
+}
+
 void EBO::Bind()
 {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
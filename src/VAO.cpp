@@ -17,6 +17,13 @@ void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type,
     VBO.Unbind();
 }
 
+void VAO::LinkInstanceAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset)
+{
+    LinkAttrib(VBO, layout, numComponents, type, stride, offset);
+    // avança o atributo a cada instância em vez de a cada vértice
+    glVertexAttribDivisor(layout, 1);
+}
+
 void VAO::Bind()
 {
     glBindVertexArray(ID);
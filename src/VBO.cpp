@@ -1,13 +1,27 @@
 #include "VBO.hpp"
 
-VBO::VBO(GLfloat *vertices, GLsizeiptr size)
+VBO::VBO(const GLfloat *vertices, GLsizeiptr size, GLenum usage)
 {
+    VBO::usage = usage;
     glGenBuffers(1, &ID);
     // informa qual VBO será usado
     glBindBuffer(GL_ARRAY_BUFFER, ID);
-    // armazena o objeto dos vértices no buffer VBO. GL_STATIC_DRAW especifica que
+    // armazena o objeto dos vértices no buffer VBO. GL_STATIC_DRAW (padrão) especifica que
     // os vértices vão ser modificados uma vez, e usados muitas vezes. Pode ser STREAM, STATIC ou DYNAMIC.
-    glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, size, vertices, usage);
+}
+
+VBO::VBO(const std::vector<GLfloat> &vertices, GLenum usage)
+    : VBO(vertices.data(), vertices.size() * sizeof(GLfloat), usage)
+{
+}
+
+void VBO::Update(const void *data, GLsizeiptr size)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    // realocar com os dados novos deixa o driver descartar o buffer antigo
+    // sem esperar a GPU terminar de desenhar o frame anterior
+    glBufferData(GL_ARRAY_BUFFER, size, data, usage);
 }
 
 void VBO::Bind()
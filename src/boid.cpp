@@ -1,4 +1,9 @@
 #include "boid.hpp"
+#include "grid.hpp"
+#include "boidSoA.hpp"
+#include "octree.hpp"
+#include "scene.hpp"
+#include <cmath>
 #include <random>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -13,17 +18,20 @@ Boid::Boid(glm::vec3 pos, glm::vec3 vel, bool objective, bool alwaysPerceiveLead
     isObjective = objective;
     this->alwaysPerceiveLeader = alwaysPerceiveLeader;
     
-    // Inicializar animação das asas com fase aleatória baseada no endereço do objeto
-    wingPhase = static_cast<float>(reinterpret_cast<uintptr_t>(this) % 628) / 100.0f; // 0 a 6.28
+    // Fase das asas começa em 0; quem cria o boid pode sortear outra (Flock::add)
+    wingPhase = 0.0f;
     wingFrequency = 5.0f;  // 5 batidas por segundo
+
+    prevPosition = position;
+    prevVelocity = velocity;
+    prevWingPhase = wingPhase;
 }
 
-Boid::Boid(bool objective, bool alwaysPerceiveLeader)
+Boid::Boid(std::mt19937& gen, bool objective, bool alwaysPerceiveLeader)
 {
-    // Usar endereço do objeto como seed (único para cada boid)
-    std::mt19937 gen(reinterpret_cast<uintptr_t>(this));
     std::uniform_real_distribution<float> randomPos(-5.0, 5.0);
     std::uniform_real_distribution<float> randomVel(-1.0, 1.0);
+    std::uniform_real_distribution<float> randomPhase(0.0f, 6.28f);
         
     position = glm::vec3(randomPos(gen), randomPos(gen), randomPos(gen));
     velocity = glm::vec3(randomVel(gen), randomVel(gen), randomVel(gen));
@@ -34,29 +42,27 @@ Boid::Boid(bool objective, bool alwaysPerceiveLeader)
     isObjective = objective;
     this->alwaysPerceiveLeader = alwaysPerceiveLeader;
     
-    // Inicializar animação das asas com fase aleatória baseada no endereço do objeto
-    wingPhase = static_cast<float>(reinterpret_cast<uintptr_t>(this) % 628) / 100.0f; // 0 a 6.28
+    // Inicializar animação das asas com fase aleatória
+    wingPhase = randomPhase(gen); // 0 a 6.28
     wingFrequency = 5.0f;  // 5 batidas por segundo
-}
 
-// Árvores globais
-extern std::vector<Tree> globalTrees;
+    prevPosition = position;
+    prevVelocity = velocity;
+    prevWingPhase = wingPhase;
+}
 
-void Boid::update(std::vector<Boid> flock_list, float delta_time)
+void Boid::update(const BoidSoA& state, const SpatialGrid& grid, float delta_time, const FlockOctree* octree)
 {
-    // Aplicar comportamentos de bando
-    flock(flock_list);
-    
-    // Aplicar comportamento de objetivo (seguir líder)
-    if (!isObjective)
-    {
-        glm::vec3 objective_update = objective(flock_list);
-        objective_update *= 1.5f;  // Peso para seguir o líder
-        applyForce(objective_update);
-    }
+    // Guardar o estado atual para a interpolação da renderização
+    prevPosition = position;
+    prevVelocity = velocity;
+    prevWingPhase = wingPhase;
+
+    // Aplicar comportamentos de bando e de objetivo (seguir líder)
+    flock(state, grid, octree);
     
     // Evitar obstáculos
-    glm::vec3 obstacleAvoidance = avoidObstacles(globalTrees);
+    glm::vec3 obstacleAvoidance = avoidObstacles(globalTreeGrid);
     obstacleAvoidance *= 30.0f;  // Peso 
     applyForce(obstacleAvoidance);
     
@@ -86,11 +92,36 @@ void Boid::applyForce(glm::vec3 force)
     acceleration += force;
 }
 
-void Boid::flock(const std::vector<Boid>& boids)
+// Passada única pelos vizinhos: acumula separação, alinhamento e coesão juntos
+void Boid::flock(const BoidSoA& state, const SpatialGrid& grid, const FlockOctree* octree)
 {
-    glm::vec3 sep = separation(boids);
-    glm::vec3 ali = alignment(boids);
-    glm::vec3 coh = cohesion(boids);
+    const float desiredSeparation = 25.0f;
+    const float separationSq = desiredSeparation * desiredSeparation;
+    // Com a octree a grade só cobre o raio de separação
+    const float perceptionSq = octree ? 0.0f : perceptionRadius * perceptionRadius;
+
+    // Cada trecho da grade é contíguo nos arrays SoA
+    NeighborSums sums;
+    grid.forEachNeighborRange(position, [&](int begin, int end)
+    {
+        state.accumulate(position, begin, end, separationSq, perceptionSq, sums);
+    });
+
+    if (octree)
+    {
+        octree->accumulate(position, perceptionRadius, sums);
+        // A árvore sempre soma o próprio boid uma vez (estado do início do tick)
+        if (sums.neighborCount > 0)
+        {
+            sums.neighborCount--;
+            sums.positionSum -= position;
+            sums.velocitySum -= velocity;
+        }
+    }
+    
+    glm::vec3 sep = separation(sums.separationSum, sums.separationCount);
+    glm::vec3 ali = alignment(sums.velocitySum, sums.neighborCount);
+    glm::vec3 coh = cohesion(sums.positionSum, sums.neighborCount);
     
     // Pesos para cada força
     sep *= 2.0f;  
@@ -100,31 +131,18 @@ void Boid::flock(const std::vector<Boid>& boids)
     applyForce(sep);
     applyForce(ali);
     applyForce(coh);
+    
+    if (!isObjective && state.size() > 0)
+    {
+        glm::vec3 objective_update = objective(state.leaderPosition);
+        objective_update *= 1.5f;  // Peso para seguir o líder
+        applyForce(objective_update);
+    }
 }
 
 // separacao - evitar colisão com vizinhos próximos
-glm::vec3 Boid::separation(const std::vector<Boid> &boids)
+glm::vec3 Boid::separation(glm::vec3 steer, int count)
 {
-    float desiredSeparation = 25.0f;
-    glm::vec3 steer = glm::vec3(0.0f);
-    int count = 0;
-    
-    for (const auto& other : boids)
-    {
-        float d = glm::distance(position, other.position);
-        
-        // Se ta muito perto, mas não é ele mesmo
-        if (d > 0.0f && d < desiredSeparation)
-        {
-            // Calcular vetor apontando para longe do vizinho
-            glm::vec3 diff = position - other.position;
-            diff = glm::normalize(diff);
-            diff /= d;  // Quanto mais perto, maior a força
-            steer += diff;
-            count++;
-        }
-    }
-    
     // Média dos vetores de afastamento
     if (count > 0)
     {
@@ -146,22 +164,8 @@ glm::vec3 Boid::separation(const std::vector<Boid> &boids)
 }
 
 // Regra 2: ALINHAMENTO - Alinhar com a direção média dos vizinhos
-glm::vec3 Boid::alignment(const std::vector<Boid> &boids)
+glm::vec3 Boid::alignment(glm::vec3 sum, int count)
 {
-    glm::vec3 sum = glm::vec3(0.0f);
-    int count = 0;
-    
-    for (const auto& other : boids)
-    {
-        float d = glm::distance(position, other.position);
-        
-        if (d > 0.0f && d < perceptionRadius)
-        {
-            sum += other.velocity;
-            count++;
-        }
-    }
-    
     if (count > 0)
     {
         sum /= (float)count;
@@ -179,22 +183,8 @@ glm::vec3 Boid::alignment(const std::vector<Boid> &boids)
 }
 
 // Regra 3: COESÃO - Mover em direção à posição média dos vizinhos
-glm::vec3 Boid::cohesion(const std::vector<Boid> &boids)
+glm::vec3 Boid::cohesion(glm::vec3 sum, int count)
 {
-    glm::vec3 sum = glm::vec3(0.0f);
-    int count = 0;
-    
-    for (const auto& other : boids)
-    {
-        float d = glm::distance(position, other.position);
-        
-        if (d > 0.0f && d < perceptionRadius)
-        {
-            sum += other.position;
-            count++;
-        }
-    }
-    
     if (count > 0)
     {
         sum /= (float)count;
@@ -220,17 +210,15 @@ glm::vec3 Boid::seek(glm::vec3 target)
 }
 
 // Regra especial: OBJETIVO - Seguir o boid [0] (líder do bando)
-glm::vec3 Boid::objective(const std::vector<Boid> &boids)
+glm::vec3 Boid::objective(glm::vec3 leaderPosition)
 {
-    if (isObjective || boids.empty())
+    if (isObjective)
     {
         return glm::vec3(0.0f);  // O objetivo não segue ninguém
     }
     
     // Seguir o boid [0] (líder)
-    const Boid& leader = boids[0];
-    
-    glm::vec3 desired = leader.position - position;
+    glm::vec3 desired = leaderPosition - position;
     float d = glm::length(desired);
     
     if (d > 0.0f && (d < 100.0f || this->alwaysPerceiveLeader))
@@ -308,13 +296,13 @@ void Boid::edges(float boundX, float boundY, float boundZ)
     position.z = glm::clamp(position.z, -boundZ, boundZ);
 }
 
-glm::vec3 Boid::avoidObstacles(const std::vector<Tree>& trees)
+glm::vec3 Boid::avoidObstacles(const TreeGrid& trees)
 {
-    float detectionRadius = 15.0f;  // Distância de detecção
+    float detectionRadius = OBSTACLE_DETECTION_RADIUS;  // Distância de detecção
     glm::vec3 steer = glm::vec3(0.0f);
     int count = 0;
     
-    for (const auto& tree : trees)
+    trees.forEachNear(position, detectionRadius, [&](const Tree& tree)
     {
         // Calcular distância 2D (XZ) e verificar altura
         glm::vec2 posXZ = glm::vec2(position.x, position.z);
@@ -340,7 +328,7 @@ glm::vec3 Boid::avoidObstacles(const std::vector<Tree>& trees)
                 count++;
             }
         }
-    }
+    });
     
     if (count > 0)
     {
@@ -361,19 +349,22 @@ glm::vec3 Boid::avoidObstacles(const std::vector<Tree>& trees)
     return steer;
 }
 
-glm::mat4 Boid::getModelMatrix() const
+glm::mat4 Boid::getModelMatrix(float alpha) const
 {
+    glm::vec3 renderPosition = glm::mix(prevPosition, position, alpha);
+    glm::vec3 renderVelocity = glm::mix(prevVelocity, velocity, alpha);
+
     glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, position);
+    model = glm::translate(model, renderPosition);
     
     // Orientar o boid na direção da velocidade
-    if (glm::length(velocity) > 0.001f)
+    if (glm::length(renderVelocity) > 0.001f)
     {
-        glm::vec3 forward = glm::normalize(velocity);
+        glm::vec3 forward = glm::normalize(renderVelocity);
         glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
         
         // Evitar problema quando forward é paralelo a up
-        if (abs(glm::dot(forward, up)) > 0.99f)
+        if (std::abs(glm::dot(forward, up)) > 0.99f)
         {
             up = glm::vec3(0.0f, 0.0f, 1.0f);
         }
@@ -394,3 +385,15 @@ glm::mat4 Boid::getModelMatrix() const
     
     return model;
 }
+
+float Boid::getWingPhase(float alpha) const
+{
+    // A fase volta a 0 ao passar de 2pi; desfaz a volta antes de interpolar
+    float current = wingPhase;
+    if (current < prevWingPhase)
+        current += 2.0f * 3.14159265f;
+    float phase = prevWingPhase + (current - prevWingPhase) * alpha;
+    if (phase > 2.0f * 3.14159265f)
+        phase -= 2.0f * 3.14159265f;
+    return phase;
+}
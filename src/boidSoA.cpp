@@ -0,0 +1,229 @@
+#include "boidSoA.hpp"
+#include "grid.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+// Bits ligados de uma máscara de movemask (4 bits no SSE, 8 no AVX), por
+// tabela: __builtin_popcount não existe no MSVC
+static inline int maskCount(int mask)
+{
+    static const int NIBBLE_BITS[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+    return NIBBLE_BITS[mask & 0xF] + NIBBLE_BITS[(mask >> 4) & 0xF];
+}
+
+static inline float horizontalSum(__m128 v)
+{
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    sums = _mm_add_ss(sums, shuffled);
+    return _mm_cvtss_f32(sums);
+}
+#endif
+
+#if defined(__AVX__)
+static inline float horizontalSum(__m256 v)
+{
+    return horizontalSum(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+#endif
+
+void BoidSoA::gather(const std::vector<Boid>& boids, const SpatialGrid& grid)
+{
+    count = boids.size();
+
+    // Folga no final para que uma carga de 8 floats a partir de qualquer slot válido não saia do array
+    size_t padded = (count + 7 + 7) & ~(size_t)7;
+    px.resize(padded);
+    py.resize(padded);
+    pz.resize(padded);
+    vx.resize(padded);
+    vy.resize(padded);
+    vz.resize(padded);
+    slotOf.resize(count);
+
+    const std::vector<int>& order = grid.order();
+    for (size_t slot = 0; slot < count; slot++)
+    {
+        const Boid& b = boids[order[slot]];
+        px[slot] = b.position.x;
+        py[slot] = b.position.y;
+        pz[slot] = b.position.z;
+        vx[slot] = b.velocity.x;
+        vy[slot] = b.velocity.y;
+        vz[slot] = b.velocity.z;
+        slotOf[order[slot]] = (int)slot;
+    }
+
+    leaderPosition = (count > 0) ? boids[0].position : glm::vec3(0.0f);
+}
+
+void BoidSoA::store(size_t index, glm::vec3 position, glm::vec3 velocity)
+{
+    int slot = slotOf[index];
+    px[slot] = position.x;
+    py[slot] = position.y;
+    pz[slot] = position.z;
+    vx[slot] = velocity.x;
+    vy[slot] = velocity.y;
+    vz[slot] = velocity.z;
+    if (index == 0)
+        leaderPosition = position;
+}
+
+size_t BoidSoA::size() const
+{
+    return count;
+}
+
+void BoidSoA::accumulate(glm::vec3 position, size_t begin, size_t end,
+                         float separationSq, float perceptionSq, NeighborSums& sums) const
+{
+    const float searchSq = glm::max(separationSq, perceptionSq);
+    size_t k = begin;
+
+#if defined(__AVX__)
+    // 8 vizinhos candidatos por instrução; o último bloco é mascarado pelo índice da lane
+    const __m256 ox = _mm256_set1_ps(position.x);
+    const __m256 oy = _mm256_set1_ps(position.y);
+    const __m256 oz = _mm256_set1_ps(position.z);
+    const __m256 sepLimit = _mm256_set1_ps(separationSq);
+    const __m256 percLimit = _mm256_set1_ps(perceptionSq);
+    const __m256 searchLimit = _mm256_set1_ps(searchSq);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+    __m256 sepX = zero, sepY = zero, sepZ = zero;
+    __m256 velX = zero, velY = zero, velZ = zero;
+    __m256 posX = zero, posY = zero, posZ = zero;
+    int separationCount = 0;
+    int neighborCount = 0;
+
+    for (; k < end; k += 8)
+    {
+        __m256 valid = _mm256_cmp_ps(lanes, _mm256_set1_ps((float)(end - k)), _CMP_LT_OQ);
+
+        __m256 otherX = _mm256_loadu_ps(&px[k]);
+        __m256 otherY = _mm256_loadu_ps(&py[k]);
+        __m256 otherZ = _mm256_loadu_ps(&pz[k]);
+        __m256 dx = _mm256_sub_ps(ox, otherX);
+        __m256 dy = _mm256_sub_ps(oy, otherY);
+        __m256 dz = _mm256_sub_ps(oz, otherZ);
+        __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+        // Ignora ele mesmo e quem está fora do alcance
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(d2, zero, _CMP_GT_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(d2, searchLimit, _CMP_LT_OQ));
+        __m256 sepMask = _mm256_and_ps(valid, _mm256_cmp_ps(d2, sepLimit, _CMP_LT_OQ));
+        __m256 percMask = _mm256_and_ps(valid, _mm256_cmp_ps(d2, percLimit, _CMP_LT_OQ));
+
+        // normalize(diff) / d == diff / d²; lanes com d2 = 0 são zeradas pela máscara
+        __m256 invD2 = _mm256_div_ps(one, d2);
+        sepX = _mm256_add_ps(sepX, _mm256_and_ps(sepMask, _mm256_mul_ps(dx, invD2)));
+        sepY = _mm256_add_ps(sepY, _mm256_and_ps(sepMask, _mm256_mul_ps(dy, invD2)));
+        sepZ = _mm256_add_ps(sepZ, _mm256_and_ps(sepMask, _mm256_mul_ps(dz, invD2)));
+
+        velX = _mm256_add_ps(velX, _mm256_and_ps(percMask, _mm256_loadu_ps(&vx[k])));
+        velY = _mm256_add_ps(velY, _mm256_and_ps(percMask, _mm256_loadu_ps(&vy[k])));
+        velZ = _mm256_add_ps(velZ, _mm256_and_ps(percMask, _mm256_loadu_ps(&vz[k])));
+        posX = _mm256_add_ps(posX, _mm256_and_ps(percMask, otherX));
+        posY = _mm256_add_ps(posY, _mm256_and_ps(percMask, otherY));
+        posZ = _mm256_add_ps(posZ, _mm256_and_ps(percMask, otherZ));
+
+        separationCount += maskCount(_mm256_movemask_ps(sepMask));
+        neighborCount += maskCount(_mm256_movemask_ps(percMask));
+    }
+
+    sums.separationSum += glm::vec3(horizontalSum(sepX), horizontalSum(sepY), horizontalSum(sepZ));
+    sums.velocitySum += glm::vec3(horizontalSum(velX), horizontalSum(velY), horizontalSum(velZ));
+    sums.positionSum += glm::vec3(horizontalSum(posX), horizontalSum(posY), horizontalSum(posZ));
+    sums.separationCount += separationCount;
+    sums.neighborCount += neighborCount;
+
+#elif defined(__SSE2__) || defined(_M_X64)
+    // Mesmo laço com 4 vizinhos por instrução
+    const __m128 ox = _mm_set1_ps(position.x);
+    const __m128 oy = _mm_set1_ps(position.y);
+    const __m128 oz = _mm_set1_ps(position.z);
+    const __m128 sepLimit = _mm_set1_ps(separationSq);
+    const __m128 percLimit = _mm_set1_ps(perceptionSq);
+    const __m128 searchLimit = _mm_set1_ps(searchSq);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+
+    __m128 sepX = zero, sepY = zero, sepZ = zero;
+    __m128 velX = zero, velY = zero, velZ = zero;
+    __m128 posX = zero, posY = zero, posZ = zero;
+    int separationCount = 0;
+    int neighborCount = 0;
+
+    for (; k < end; k += 4)
+    {
+        __m128 valid = _mm_cmplt_ps(lanes, _mm_set1_ps((float)(end - k)));
+
+        __m128 otherX = _mm_loadu_ps(&px[k]);
+        __m128 otherY = _mm_loadu_ps(&py[k]);
+        __m128 otherZ = _mm_loadu_ps(&pz[k]);
+        __m128 dx = _mm_sub_ps(ox, otherX);
+        __m128 dy = _mm_sub_ps(oy, otherY);
+        __m128 dz = _mm_sub_ps(oz, otherZ);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(d2, zero));
+        valid = _mm_and_ps(valid, _mm_cmplt_ps(d2, searchLimit));
+        __m128 sepMask = _mm_and_ps(valid, _mm_cmplt_ps(d2, sepLimit));
+        __m128 percMask = _mm_and_ps(valid, _mm_cmplt_ps(d2, percLimit));
+
+        __m128 invD2 = _mm_div_ps(one, d2);
+        sepX = _mm_add_ps(sepX, _mm_and_ps(sepMask, _mm_mul_ps(dx, invD2)));
+        sepY = _mm_add_ps(sepY, _mm_and_ps(sepMask, _mm_mul_ps(dy, invD2)));
+        sepZ = _mm_add_ps(sepZ, _mm_and_ps(sepMask, _mm_mul_ps(dz, invD2)));
+
+        velX = _mm_add_ps(velX, _mm_and_ps(percMask, _mm_loadu_ps(&vx[k])));
+        velY = _mm_add_ps(velY, _mm_and_ps(percMask, _mm_loadu_ps(&vy[k])));
+        velZ = _mm_add_ps(velZ, _mm_and_ps(percMask, _mm_loadu_ps(&vz[k])));
+        posX = _mm_add_ps(posX, _mm_and_ps(percMask, otherX));
+        posY = _mm_add_ps(posY, _mm_and_ps(percMask, otherY));
+        posZ = _mm_add_ps(posZ, _mm_and_ps(percMask, otherZ));
+
+        separationCount += maskCount(_mm_movemask_ps(sepMask));
+        neighborCount += maskCount(_mm_movemask_ps(percMask));
+    }
+
+    sums.separationSum += glm::vec3(horizontalSum(sepX), horizontalSum(sepY), horizontalSum(sepZ));
+    sums.velocitySum += glm::vec3(horizontalSum(velX), horizontalSum(velY), horizontalSum(velZ));
+    sums.positionSum += glm::vec3(horizontalSum(posX), horizontalSum(posY), horizontalSum(posZ));
+    sums.separationCount += separationCount;
+    sums.neighborCount += neighborCount;
+
+#else
+    for (; k < end; k++)
+    {
+        glm::vec3 diff = position - glm::vec3(px[k], py[k], pz[k]);
+        float d2 = glm::dot(diff, diff);
+
+        if (d2 <= 0.0f || d2 >= searchSq)
+            continue;
+
+        if (d2 < separationSq)
+        {
+            sums.separationSum += diff / d2;
+            sums.separationCount++;
+        }
+
+        if (d2 < perceptionSq)
+        {
+            sums.velocitySum += glm::vec3(vx[k], vy[k], vz[k]);
+            sums.positionSum += glm::vec3(px[k], py[k], pz[k]);
+            sums.neighborCount++;
+        }
+    }
+#endif
+}
@@ -8,28 +8,14 @@ Camera::Camera(int width, int height, glm::vec3 position)
     Position = position;
 }
 
-void Camera::updateMatrix(float FOVdeg, float nearPlane, float farPlane, const Flock &flock)
+void Camera::updateMatrix(float FOVdeg, float nearPlane, float farPlane, const FlockStats &stats)
 {
-    // Calcular centro do bando
-    glm::vec3 flock_center = glm::vec3(0.0f, 0.0f, 0.0f);
-    if (flock.size() > 0)
-    {
-        for (const Boid& b : flock.getBoids())
-            flock_center += b.position;
-        flock_center /= (float)flock.size();
-    }
-    
-    // Calcular velocidade média do bando
-    glm::vec3 flock_velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-    if (flock.size() > 0)
-    {
-        for (const Boid& b : flock.getBoids())
-            flock_velocity += b.velocity;
-        flock_velocity /= (float)flock.size();
-    }
+    // Centro e velocidade média do bando, mantidos por quem simula
+    glm::vec3 flock_center = stats.center;
+    glm::vec3 flock_velocity = stats.meanVelocity;
 
     // MODO 1: Torre no centro (posição alta e fixa, olhando para o centro do bando)
-    if (followCenterMode && flock.size() > 0)
+    if (followCenterMode && stats.count > 0)
     {
         // Posição alvo no alto da "torre" no centro do mundo (0, altura, 0)
         glm::vec3 targetPosition = glm::vec3(30.0f, 60.0f, 0.0f);
@@ -42,7 +28,7 @@ void Camera::updateMatrix(float FOVdeg, float nearPlane, float farPlane, const F
     }
     
     // MODO 2: Atrás do bando a distância fixa
-    else if (followLeaderMode && flock.size() > 0 && glm::length(flock_velocity) > 0.1f)
+    else if (followLeaderMode && stats.count > 0 && glm::length(flock_velocity) > 0.1f)
     {
         // Direção oposta à velocidade do bando
         glm::vec3 behind_direction = glm::normalize(-flock_velocity);
@@ -61,7 +47,7 @@ void Camera::updateMatrix(float FOVdeg, float nearPlane, float farPlane, const F
     }
     
     // MODO 3: Perpendicular ao vetor velocidade, paralelo ao chão
-    else if (perpendicularMode && flock.size() > 0 && glm::length(flock_velocity) > 0.1f)
+    else if (perpendicularMode && stats.count > 0 && glm::length(flock_velocity) > 0.1f)
     {
         // Projetar velocidade no plano XZ (remover componente Y)
         glm::vec3 velocity_ground = glm::vec3(flock_velocity.x, 0.0f, flock_velocity.z);
@@ -98,12 +84,13 @@ void Camera::updateMatrix(float FOVdeg, float nearPlane, float farPlane, const F
     projection = glm::perspective(glm::radians(FOVdeg), aspect, nearPlane, farPlane);
 
     cameraMatrix = projection * view;
+    frustum.extract(cameraMatrix);
 }
 
 void Camera::Matrix(Shader &shader, const char *uniform)
 {
     // envia as matrizes para o shader
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, uniform), 1, GL_FALSE, glm::value_ptr(cameraMatrix));
+    shader.SetMat4(uniform, cameraMatrix);
 }
 
 void Camera::Inputs(GLFWwindow *window, float deltaTime)
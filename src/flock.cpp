@@ -1,47 +1,402 @@
 #include "flock.hpp"
-#include <GLFW/glfw3.h> // GLFW
-#include <ctime>
+#include "random.hpp"
+#include "trace.hpp"
+#include <algorithm>
 #include <iostream>
 
-Flock::Flock() : gen(static_cast<unsigned int>(time(nullptr))), randomInt(0, 1000)
+// Boids por bloco do parallelFor (também indexa as somas por bloco)
+static const size_t UPDATE_GRAIN = 256;
+// Boids por bloco do teste de visibilidade (bem mais barato por boid)
+static const size_t CULL_GRAIN = 4096;
+
+void Flock::StatsSums::reset()
+{
+    positionSum = glm::vec3(0.0f);
+    velocitySum = glm::vec3(0.0f);
+    boundsMin = glm::vec3(0.0f);
+    boundsMax = glm::vec3(0.0f);
+    speedSum = 0.0f;
+    minSpeed = 0.0f;
+    maxSpeed = 0.0f;
+    count = 0;
+}
+
+void Flock::StatsSums::add(const Boid &boid)
+{
+    float speed = glm::length(boid.velocity);
+    if (count == 0)
+    {
+        boundsMin = boundsMax = boid.position;
+        minSpeed = maxSpeed = speed;
+    }
+    else
+    {
+        boundsMin = glm::min(boundsMin, boid.position);
+        boundsMax = glm::max(boundsMax, boid.position);
+        minSpeed = glm::min(minSpeed, speed);
+        maxSpeed = glm::max(maxSpeed, speed);
+    }
+    positionSum += boid.position;
+    velocitySum += boid.velocity;
+    speedSum += speed;
+    count++;
+}
+
+void Flock::StatsSums::merge(const StatsSums &other)
+{
+    if (other.count == 0)
+        return;
+    if (count == 0)
+    {
+        *this = other;
+        return;
+    }
+    positionSum += other.positionSum;
+    velocitySum += other.velocitySum;
+    boundsMin = glm::min(boundsMin, other.boundsMin);
+    boundsMax = glm::max(boundsMax, other.boundsMax);
+    speedSum += other.speedSum;
+    minSpeed = glm::min(minSpeed, other.minSpeed);
+    maxSpeed = glm::max(maxSpeed, other.maxSpeed);
+    count += other.count;
+}
+
+Flock::Flock() : updateMode(UpdateMode::Jacobi), approximate(false), perceptionRadius(50.0f), pool(new ThreadPool()), gen(makeRandomStream(RandomStream::Flock))
 {
     alwaysPerceiveLeader = false;
+    statsSums.reset();
+    refreshStats();
 }
 
-void Flock::add()
+void Flock::refreshStats()
+{
+    stats.count = statsSums.count;
+    stats.boundsMin = statsSums.boundsMin;
+    stats.boundsMax = statsSums.boundsMax;
+    stats.minSpeed = statsSums.minSpeed;
+    stats.maxSpeed = statsSums.maxSpeed;
+    if (statsSums.count > 0)
+    {
+        float inverseCount = 1.0f / (float)statsSums.count;
+        stats.center = statsSums.positionSum * inverseCount;
+        stats.meanVelocity = statsSums.velocitySum * inverseCount;
+        stats.meanSpeed = statsSums.speedSum * inverseCount;
+    }
+    else
+    {
+        stats.center = glm::vec3(0.0f);
+        stats.meanVelocity = glm::vec3(0.0f);
+        stats.meanSpeed = 0.0f;
+    }
+}
+
+BoidHandle Flock::push(const Boid &b)
+{
+    uint32_t slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = (uint32_t)slots.size();
+        slots.push_back({0, 1});
+    }
+    slots[slot].index = (uint32_t)flock_list.size();
+    boidSlot.push_back(slot);
+    flock_list.push_back(b);
+
+    statsSums.add(b);
+    refreshStats();
+    return {slot, slots[slot].generation};
+}
+
+BoidHandle Flock::add()
 {
     bool is_objective = (flock_list.size() == 0);
     // Novos boids usam o estado central do Flock
-    Boid b(is_objective, this->alwaysPerceiveLeader);
-    flock_list.push_back(b);
+    Boid b(gen, is_objective, this->alwaysPerceiveLeader);
+    b.perceptionRadius = perceptionRadius;
+    return push(b);
 }
 
-void Flock::add(glm::vec3 position, glm::vec3 velocity)
+BoidHandle Flock::add(glm::vec3 position, glm::vec3 velocity)
 {
     bool is_objective = (flock_list.size() == 0);
     // Novos boids usam o estado central do Flock
     Boid b(position, velocity, is_objective, this->alwaysPerceiveLeader);
-    flock_list.push_back(b);
+    b.perceptionRadius = perceptionRadius;
+    std::uniform_real_distribution<float> randomPhase(0.0f, 6.28f);
+    b.wingPhase = randomPhase(gen);
+    // Sem isso a interpolação até o próximo tick sairia da fase 0 do construtor
+    b.prevWingPhase = b.wingPhase;
+    return push(b);
+}
+
+void Flock::add(int count)
+{
+    // Reservar só o pedido anularia o crescimento geométrico do vetor e
+    // add(k) repetido com k pequeno realocaria a cada chamada
+    size_t needed = flock_list.size() + (size_t)glm::max(count, 0);
+    if (needed > flock_list.capacity())
+        reserve(std::max(needed, 2 * flock_list.capacity()));
+    for (int i = 0; i < count; i++)
+    {
+        add();
+    }
+}
+
+void Flock::reserve(size_t count)
+{
+    flock_list.reserve(count);
+    boidSlot.reserve(count);
+    slots.reserve(count);
+}
+
+// Troca o boid com o último e encolhe o vetor: O(1), só o último muda de lugar
+void Flock::removeAt(size_t index)
+{
+    // Tira o boid das somas; caixa e extremos continuam valendo como limite
+    const Boid &removed = flock_list[index];
+    statsSums.positionSum -= removed.position;
+    statsSums.velocitySum -= removed.velocity;
+    statsSums.speedSum -= glm::length(removed.velocity);
+    statsSums.count--;
+    refreshStats();
+
+    uint32_t slot = boidSlot[index];
+    size_t last = flock_list.size() - 1;
+    if (index != last)
+    {
+        flock_list[index] = flock_list[last];
+        boidSlot[index] = boidSlot[last];
+        slots[boidSlot[index]].index = (uint32_t)index;
+    }
+    flock_list.pop_back();
+    boidSlot.pop_back();
+
+    // Handles antigos deste slot deixam de valer
+    if (++slots[slot].generation == 0)
+        slots[slot].generation = 1;
+    freeSlots.push_back(slot);
 }
 
 // deleta um boid aleatório (nunca deleta o líder)
 void Flock::clear()
 {
-    if (flock_list.size() > 1)
+    removeRandom(1);
+}
+
+void Flock::removeRandom(int count)
+{
+    for (int i = 0; i < count && flock_list.size() > 1; i++)
     {
-        // Gera índice de 1 até size()-1 para nunca pegar o líder (índice 0)
-        int randomIndex = 1 + (randomInt(gen) % (flock_list.size() - 1));
-        flock_list.erase(flock_list.begin() + randomIndex);
+        // Índice de 1 até size()-1 para nunca pegar o líder (índice 0)
+        std::uniform_int_distribution<size_t> randomIndex(1, flock_list.size() - 1);
+        removeAt(randomIndex(gen));
     }
 }
 
+bool Flock::remove(BoidHandle handle)
+{
+    if (!isValid(handle))
+        return false;
+    // O líder precisa ficar no índice 0 (BoidSoA lê a posição dele de lá):
+    // trocá-lo pelo último poria um boid comum no lugar. Só sai sozinho.
+    size_t index = slots[handle.slot].index;
+    if (index == 0 && flock_list.size() > 1)
+        return false;
+    removeAt(index);
+    return true;
+}
+
+bool Flock::isValid(BoidHandle handle) const
+{
+    return handle.slot < slots.size() && handle.generation != 0 && slots[handle.slot].generation == handle.generation;
+}
+
+Boid *Flock::get(BoidHandle handle)
+{
+    return isValid(handle) ? &flock_list[slots[handle.slot].index] : nullptr;
+}
+
+const Boid *Flock::get(BoidHandle handle) const
+{
+    return isValid(handle) ? &flock_list[slots[handle.slot].index] : nullptr;
+}
+
+BoidHandle Flock::handleAt(size_t index) const
+{
+    if (index >= boidSlot.size())
+        return BoidHandle();
+    uint32_t slot = boidSlot[index];
+    return {slot, slots[slot].generation};
+}
+
 void Flock::update(float delta_time, float boundX, float boundY, float boundZ)
 {
-    for (auto &boid : flock_list)
+    TRACE_ZONE("Flock::update");
+
+    // Célula do tamanho do maior raio de busca (percepção ou separação = 25);
+    // no modo aproximado a percepção fica com a octree e a grade só separa
+    float cellSize = 25.0f;
+    if (!approximate)
+    {
+        for (const auto &boid : flock_list)
+        {
+            cellSize = glm::max(cellSize, boid.perceptionRadius);
+        }
+    }
+    // Estruturas da busca de vizinhos
+    const FlockOctree *tree = nullptr;
+    {
+        TRACE_ZONE("vizinhos: grade + SoA");
+        grid.build(flock_list, glm::vec3(-boundX, 0.0f, -boundZ), glm::vec3(boundX, boundY, boundZ), cellSize);
+        state.gather(flock_list, grid);
+    }
+
+    // A árvore reflete o início do tick (também no modo Gauss-Seidel)
+    if (approximate)
+    {
+        TRACE_ZONE("vizinhos: octree");
+        octree.build(state);
+        tree = &octree;
+    }
+
+    if (updateMode == UpdateMode::GaussSeidel)
+    {
+        TRACE_ZONE("steering (sequencial)");
+        statsSums.reset();
+        for (size_t i = 0; i < flock_list.size(); i++)
+        {
+            Boid &boid = flock_list[i];
+            boid.update(state, grid, delta_time, tree);
+            boid.edges(boundX, boundY, boundZ); // Aplicar colisão com bordas
+            // Os próximos boids já leem a posição nova
+            state.store(i, boid.position, boid.velocity);
+            statsSums.add(boid);
+        }
+        refreshStats();
+        return;
+    }
+
+    // Jacobi: a cópia SoA guarda o tick anterior e fica somente leitura;
+    // cada boid só escreve a própria entrada de flock_list. Como ninguém
+    // escreve no que os outros leem, os blocos rodam em paralelo.
+    // As estatísticas saem do mesmo laço, com uma soma por bloco de
+    // UPDATE_GRAIN boids. O pool pode entregar um intervalo maior (sem
+    // workers ou com um bloco só ele roda tudo de uma vez), então o
+    // intervalo é percorrido em blocos e cada um escreve a sua soma.
+    size_t numChunks = (flock_list.size() + UPDATE_GRAIN - 1) / UPDATE_GRAIN;
+    chunkSums.resize(numChunks);
+    auto updateRange = [&](size_t begin, size_t end)
+    {
+        // Um evento por intervalo: consulta aos vizinhos + forças de cada boid
+        TRACE_ZONE("steering (bloco)");
+        for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += UPDATE_GRAIN)
+        {
+            size_t chunkEnd = std::min(chunkBegin + UPDATE_GRAIN, end);
+            StatsSums &sums = chunkSums[chunkBegin / UPDATE_GRAIN];
+            sums.reset();
+            for (size_t i = chunkBegin; i < chunkEnd; i++)
+            {
+                flock_list[i].update(state, grid, delta_time, tree);
+                flock_list[i].edges(boundX, boundY, boundZ); // Aplicar colisão com bordas
+                sums.add(flock_list[i]);
+            }
+        }
+    };
+    pool->parallelFor(flock_list.size(), UPDATE_GRAIN, updateRange);
+
+    // Junta na ordem dos blocos: o resultado não depende das threads
+    statsSums.reset();
+    for (size_t c = 0; c < numChunks; c++)
+        statsSums.merge(chunkSums[c]);
+    refreshStats();
+}
+
+void Flock::cull(const Frustum &frustum, float alpha, float radius, std::vector<uint32_t> &visible)
+{
+    TRACE_ZONE("Flock::cull");
+    size_t count = flock_list.size();
+    cullX.resize(count);
+    cullY.resize(count);
+    cullZ.resize(count);
+    cullVisible.resize(count);
+
+    // Cada bloco copia os centros interpolados para SoA e testa de uma vez
+    auto cullRange = [&](size_t begin, size_t end)
     {
-        boid.update(flock_list, delta_time);
-        boid.edges(boundX, boundY, boundZ); // Aplicar colisão com bordas
+        for (size_t i = begin; i < end; i++)
+        {
+            glm::vec3 center = glm::mix(flock_list[i].prevPosition, flock_list[i].position, alpha);
+            cullX[i] = center.x;
+            cullY[i] = center.y;
+            cullZ[i] = center.z;
+        }
+        frustum.cullSpheres(&cullX[begin], &cullY[begin], &cullZ[begin], radius, end - begin, &cullVisible[begin]);
+    };
+    pool->parallelFor(count, CULL_GRAIN, cullRange);
+
+    // Compacta sem desvio: escreve sempre e só avança nos visíveis
+    visible.resize(count);
+    size_t numVisible = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        visible[numVisible] = (uint32_t)i;
+        numVisible += cullVisible[i];
     }
+    visible.resize(numVisible);
+}
+
+void Flock::setUpdateMode(UpdateMode mode)
+{
+    updateMode = mode;
+}
+
+UpdateMode Flock::getUpdateMode() const
+{
+    return updateMode;
+}
+
+void Flock::setApproximation(bool enabled)
+{
+    approximate = enabled;
+}
+
+bool Flock::getApproximation() const
+{
+    return approximate;
+}
+
+void Flock::setOpeningAngle(float angle)
+{
+    octree.setOpeningAngle(angle);
+}
+
+void Flock::setPerceptionRadius(float radius)
+{
+    perceptionRadius = radius;
+    for (Boid &b : flock_list)
+    {
+        b.perceptionRadius = radius;
+    }
+}
+
+void Flock::setThreadCount(unsigned int numThreads)
+{
+    pool.reset(new ThreadPool(numThreads));
+}
+
+unsigned int Flock::getThreadCount() const
+{
+    return pool->size();
+}
+
+void Flock::reserveTrace()
+{
+    pool->reserveTrace();
 }
 
 int Flock::size() const
@@ -49,6 +404,19 @@ int Flock::size() const
     return flock_list.size();
 }
 
+const FlockStats &Flock::getStats() const
+{
+    return stats;
+}
+
+void Flock::recomputeStats()
+{
+    statsSums.reset();
+    for (const Boid &b : flock_list)
+        statsSums.add(b);
+    refreshStats();
+}
+
 std::vector<Boid> &Flock::getBoids()
 {
     return flock_list;
@@ -59,6 +427,7 @@ const std::vector<Boid> &Flock::getBoids() const
     return flock_list;
 }
 
+#ifndef BOIDS_HEADLESS
 void Flock::inputs(GLFWwindow *window)
 {
     // processa cada input para movimentação da câmera
@@ -69,14 +438,7 @@ void Flock::inputs(GLFWwindow *window)
     
     if (glfwGetKey(window, GLFW_KEY_KP_MULTIPLY) == GLFW_PRESS)
     {
-        glm::vec3 flock_center = glm::vec3(0.0f, 0.0f, 0.0f);
-        if (this->flock_list.size() > 0)
-        {
-            for (const Boid &b : this->flock_list)
-                flock_center += b.position;
-            flock_center /= (float)this->flock_list.size();
-        }
-        this->add(flock_center, glm::vec3(0.0f, 0.0f, 0.0f));
+        this->add(stats.center, glm::vec3(0.0f, 0.0f, 0.0f));
     }
     
     if (glfwGetKey(window, GLFW_KEY_KP_DIVIDE) == GLFW_PRESS)
@@ -88,9 +450,38 @@ void Flock::inputs(GLFWwindow *window)
     
     if (glfwGetKey(window, GLFW_KEY_KP_SUBTRACT) == GLFW_PRESS)
     {
-        this->clear();
-        this->clear();
+        this->removeRandom(2);
+    }
+    static bool jKeyWasPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS)
+    {
+        if (!jKeyWasPressed)
+        {
+            this->updateMode = (this->updateMode == UpdateMode::Jacobi) ? UpdateMode::GaussSeidel : UpdateMode::Jacobi;
+            std::cout << "Modo de atualizacao: " << (this->updateMode == UpdateMode::Jacobi ? "Jacobi" : "Gauss-Seidel") << std::endl;
+            jKeyWasPressed = true;
+        }
+    }
+    else
+    {
+        jKeyWasPressed = false;
     }
+
+    static bool bKeyWasPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS)
+    {
+        if (!bKeyWasPressed)
+        {
+            this->approximate = !this->approximate;
+            std::cout << "Coesao/alinhamento por octree: " << (this->approximate ? "ligado" : "desligado") << std::endl;
+            bKeyWasPressed = true;
+        }
+    }
+    else
+    {
+        bKeyWasPressed = false;
+    }
+
     static bool vKeyWasPressed = false;
     if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS)
     {
@@ -116,4 +507,5 @@ void Flock::inputs(GLFWwindow *window)
     {
         vKeyWasPressed = false;
     }
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,177 @@
+#include "frustum.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+BoundingBox meshBounds(const float *vertices, size_t vertexCount, size_t stride)
+{
+    if (vertexCount == 0)
+        return {glm::vec3(0.0f), glm::vec3(0.0f)};
+    BoundingBox box = {glm::vec3(vertices[0], vertices[1], vertices[2]), glm::vec3(vertices[0], vertices[1], vertices[2])};
+    for (size_t i = 1; i < vertexCount; i++)
+    {
+        const float *v = vertices + i * stride;
+        glm::vec3 p(v[0], v[1], v[2]);
+        box.min = glm::min(box.min, p);
+        box.max = glm::max(box.max, p);
+    }
+    return box;
+}
+
+float meshRadius(const float *vertices, size_t vertexCount, size_t stride)
+{
+    float radiusSq = 0.0f;
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        const float *v = vertices + i * stride;
+        radiusSq = std::max(radiusSq, v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    }
+    return std::sqrt(radiusSq);
+}
+
+BoundingBox transformBounds(const BoundingBox &box, const glm::mat4 &model)
+{
+    // Arvo: cada eixo da matriz contribui com o menor/maior dos dois extremos
+    BoundingBox result = {glm::vec3(model[3]), glm::vec3(model[3])};
+    for (int axis = 0; axis < 3; axis++)
+    {
+        glm::vec3 a = glm::vec3(model[axis]) * box.min[axis];
+        glm::vec3 b = glm::vec3(model[axis]) * box.max[axis];
+        result.min += glm::min(a, b);
+        result.max += glm::max(a, b);
+    }
+    return result;
+}
+
+BoundingBox mergeBounds(const BoundingBox &a, const BoundingBox &b)
+{
+    return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+}
+
+Frustum::Frustum()
+{
+    // Sem extract, nada é descartado
+    for (glm::vec4 &plane : planes)
+        plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+void Frustum::extract(const glm::mat4 &m)
+{
+    // Linhas da matriz (o glm guarda por coluna)
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0; // esquerda
+    planes[1] = row3 - row0; // direita
+    planes[2] = row3 + row1; // baixo
+    planes[3] = row3 - row1; // cima
+    planes[4] = row3 + row2; // perto (profundidade -1..1 do OpenGL)
+    planes[5] = row3 - row2; // longe
+    for (glm::vec4 &plane : planes)
+        plane /= glm::length(glm::vec3(plane));
+}
+
+bool Frustum::intersectsSphere(glm::vec3 center, float radius) const
+{
+    for (const glm::vec4 &plane : planes)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::intersectsBox(const BoundingBox &box) const
+{
+    for (const glm::vec4 &plane : planes)
+    {
+        // Canto da caixa mais adiante na direção da normal
+        glm::vec3 farthest(plane.x >= 0.0f ? box.max.x : box.min.x,
+                           plane.y >= 0.0f ? box.max.y : box.min.y,
+                           plane.z >= 0.0f ? box.max.z : box.min.z);
+        if (glm::dot(glm::vec3(plane), farthest) + plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+void Frustum::cullSpheres(const float *x, const float *y, const float *z, float radius,
+                          size_t count, uint8_t *visible) const
+{
+    size_t i = 0;
+#if defined(__AVX__)
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (int p = 0; p < 6; p++)
+    {
+        planeX[p] = _mm256_set1_ps(planes[p].x);
+        planeY[p] = _mm256_set1_ps(planes[p].y);
+        planeZ[p] = _mm256_set1_ps(planes[p].z);
+        // O raio entra no termo constante: dist + r >= 0
+        planeW[p] = _mm256_set1_ps(planes[p].w + radius);
+    }
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 cx = _mm256_loadu_ps(x + i);
+        __m256 cy = _mm256_loadu_ps(y + i);
+        __m256 cz = _mm256_loadu_ps(z + i);
+        // Menor distância aos 6 planos; visível se não for negativa
+        __m256 nearest = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[0], cx), _mm256_mul_ps(planeY[0], cy)),
+                                       _mm256_add_ps(_mm256_mul_ps(planeZ[0], cz), planeW[0]));
+        for (int p = 1; p < 6; p++)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], cx), _mm256_mul_ps(planeY[p], cy)),
+                                            _mm256_add_ps(_mm256_mul_ps(planeZ[p], cz), planeW[p]));
+            nearest = _mm256_min_ps(nearest, distance);
+        }
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(nearest, zero, _CMP_GE_OQ));
+        for (int lane = 0; lane < 8; lane++)
+            visible[i + lane] = (uint8_t)((mask >> lane) & 1);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (int p = 0; p < 6; p++)
+    {
+        planeX[p] = _mm_set1_ps(planes[p].x);
+        planeY[p] = _mm_set1_ps(planes[p].y);
+        planeZ[p] = _mm_set1_ps(planes[p].z);
+        planeW[p] = _mm_set1_ps(planes[p].w + radius);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(x + i);
+        __m128 cy = _mm_loadu_ps(y + i);
+        __m128 cz = _mm_loadu_ps(z + i);
+        __m128 nearest = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[0], cx), _mm_mul_ps(planeY[0], cy)),
+                                    _mm_add_ps(_mm_mul_ps(planeZ[0], cz), planeW[0]));
+        for (int p = 1; p < 6; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)),
+                                         _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+            nearest = _mm_min_ps(nearest, distance);
+        }
+        int mask = _mm_movemask_ps(_mm_cmpge_ps(nearest, zero));
+        for (int lane = 0; lane < 4; lane++)
+            visible[i + lane] = (uint8_t)((mask >> lane) & 1);
+    }
+#endif
+    // Resto (ou tudo, sem SIMD)
+    for (; i < count; i++)
+    {
+        float nearest = 0.0f;
+        for (int p = 0; p < 6; p++)
+        {
+            float distance = planes[p].x * x[i] + planes[p].y * y[i] + planes[p].z * z[i] + planes[p].w + radius;
+            nearest = (p == 0) ? distance : std::min(nearest, distance);
+        }
+        visible[i] = nearest >= 0.0f ? 1 : 0;
+    }
+}
@@ -0,0 +1,38 @@
+#include "glCompute.hpp"
+
+#ifndef GL_VERSION_4_3
+PFNGLDISPATCHCOMPUTEPROC glad_glDispatchCompute = nullptr;
+PFNGLMEMORYBARRIERPROC glad_glMemoryBarrier = nullptr;
+#endif
+#ifndef GL_VERSION_4_0
+PFNGLDRAWELEMENTSINDIRECTPROC glad_glDrawElementsIndirect = nullptr;
+#endif
+
+static bool computeLoaded = false;
+
+bool loadComputeFunctions(GLADloadproc load)
+{
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major < 4 || (major == 4 && minor < 3))
+        return computeLoaded = false;
+
+    computeLoaded = true;
+#ifndef GL_VERSION_4_3
+    glad_glDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)load("glDispatchCompute");
+    glad_glMemoryBarrier = (PFNGLMEMORYBARRIERPROC)load("glMemoryBarrier");
+    computeLoaded = computeLoaded && glad_glDispatchCompute && glad_glMemoryBarrier;
+#endif
+#ifndef GL_VERSION_4_0
+    glad_glDrawElementsIndirect = (PFNGLDRAWELEMENTSINDIRECTPROC)load("glDrawElementsIndirect");
+    computeLoaded = computeLoaded && glad_glDrawElementsIndirect;
+#endif
+    (void)load;
+    return computeLoaded;
+}
+
+bool computeFunctionsLoaded()
+{
+    return computeLoaded;
+}
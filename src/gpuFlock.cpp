@@ -0,0 +1,449 @@
+#include "gpuFlock.hpp"
+#include "glCompute.hpp"
+#include "scene.hpp"
+#include "trace.hpp"
+
+// Mesmo tamanho de grupo de flock.comp (local_size_x)
+static const GLuint GPU_GROUP_SIZE = 256;
+// count, instanceCount, firstIndex, baseVertex, baseInstance (DrawCommand de flock.comp)
+static const int GPU_DRAW_COMMAND_UINTS = 5;
+// flock.comp guarda os limites dos níveis em um vec3
+static_assert(LOD_LEVELS == 4, "LOD_LEVELS diferente de flock.comp");
+
+GpuFlock::GpuFlock()
+    : boidBuffers{0, 0}, current(0), gridBuffer(0), sortedBuffer(0), treeBuffer(0), treeCellBuffer(0), statsBuffer(0), drawCommandBuffer(0),
+      numBoids(0), gridCells(0), cellSize(50.0f), numTrees(0), stats(), statsReadbacks{}, statsFences{}, nextReadback(0)
+{
+}
+
+// statsBuffer de flock.comp: centro/contagem, velocidade média/escalar
+// média, mínimo da caixa/velocidade mínima, máximo da caixa/velocidade máxima
+static FlockStats statsFromValues(const glm::vec4 values[4])
+{
+    FlockStats result;
+    result.count = (int)values[0].w;
+    result.center = glm::vec3(values[0]);
+    result.meanVelocity = glm::vec3(values[1]);
+    result.meanSpeed = values[1].w;
+    result.boundsMin = glm::vec3(values[2]);
+    result.minSpeed = values[2].w;
+    result.boundsMax = glm::vec3(values[3]);
+    result.maxSpeed = values[3].w;
+    return result;
+}
+
+bool GpuFlock::init(const char *computeFile)
+{
+    if (!computeFunctionsLoaded())
+        return false;
+
+    program.reset(new Shader(computeFile));
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program->ID, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE)
+    {
+        program->Delete();
+        program.reset();
+        return false;
+    }
+
+    passLoc = program->GetUniformLocation("pass");
+    numBoidsLoc = program->GetUniformLocation("numBoids");
+    numCellsLoc = program->GetUniformLocation("numCells");
+    gridOriginLoc = program->GetUniformLocation("gridOrigin");
+    gridInvCellSizeLoc = program->GetUniformLocation("gridInvCellSize");
+    gridDimsLoc = program->GetUniformLocation("gridDims");
+    boundsLoc = program->GetUniformLocation("bounds");
+    deltaTimeLoc = program->GetUniformLocation("deltaTime");
+    treeOriginLoc = program->GetUniformLocation("treeOrigin");
+    treeInvCellSizeLoc = program->GetUniformLocation("treeInvCellSize");
+    treeDimsLoc = program->GetUniformLocation("treeDims");
+    numTreesLoc = program->GetUniformLocation("numTrees");
+    alphaLoc = program->GetUniformLocation("alpha");
+    wingAnimationLoc = program->GetUniformLocation("wingAnimation");
+    indirectLoc = program->GetUniformLocation("indirect");
+    cullEnabledLoc = program->GetUniformLocation("cullEnabled");
+    frustumPlanesLoc = program->GetUniformLocation("frustumPlanes[0]");
+    cullRadiusLoc = program->GetUniformLocation("cullRadius");
+    lodCameraLoc = program->GetUniformLocation("lodCamera");
+    lodDistanceSqLoc = program->GetUniformLocation("lodDistanceSq");
+
+    glGenBuffers(2, boidBuffers);
+    glGenBuffers(1, &gridBuffer);
+    glGenBuffers(1, &sortedBuffer);
+    glGenBuffers(1, &treeBuffer);
+    glGenBuffers(1, &treeCellBuffer);
+    glGenBuffers(1, &statsBuffer);
+    glGenBuffers(1, &drawCommandBuffer);
+
+    // Nenhum SSBO fica vazio (vincular buffer sem memória é erro)
+    GLuint buffers[] = {boidBuffers[0], boidBuffers[1], gridBuffer, sortedBuffer, treeBuffer, treeCellBuffer};
+    for (GLuint buffer : buffers)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GpuBoid), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, 4 * sizeof(glm::vec4), nullptr, GL_DYNAMIC_READ);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawCommandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, LOD_LEVELS * GPU_DRAW_COMMAND_UINTS * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glGenBuffers(GPU_STATS_READBACKS, statsReadbacks);
+    for (GLuint buffer : statsReadbacks)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, 4 * sizeof(glm::vec4), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
+bool GpuFlock::isReady() const
+{
+    return program != nullptr;
+}
+
+void GpuFlock::Delete()
+{
+    if (!isReady())
+        return;
+    glDeleteBuffers(2, boidBuffers);
+    glDeleteBuffers(1, &gridBuffer);
+    glDeleteBuffers(1, &sortedBuffer);
+    glDeleteBuffers(1, &treeBuffer);
+    glDeleteBuffers(1, &treeCellBuffer);
+    glDeleteBuffers(1, &statsBuffer);
+    glDeleteBuffers(1, &drawCommandBuffer);
+    glDeleteBuffers(GPU_STATS_READBACKS, statsReadbacks);
+    for (GLsync &fence : statsFences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    program->Delete();
+    program.reset();
+}
+
+int GpuFlock::size() const
+{
+    return (int)numBoids;
+}
+
+void GpuFlock::dispatch(Pass pass, GLuint numItems)
+{
+    program->SetInt(passLoc, pass);
+    glDispatchCompute((numItems + GPU_GROUP_SIZE - 1) / GPU_GROUP_SIZE, 1, 1);
+    // Cada passada lê o que a anterior escreveu
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void GpuFlock::uploadTrees()
+{
+    // Mesma grade 2D que a CPU usa (globalTreeGrid), árvores já agrupadas por célula
+    const std::vector<Tree> &trees = globalTreeGrid.trees();
+    numTrees = trees.size();
+    std::vector<glm::vec4> treeData(glm::max(numTrees, (size_t)1), glm::vec4(0.0f));
+    for (size_t t = 0; t < numTrees; t++)
+        treeData[t] = glm::vec4(trees[t].position, trees[t].height);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, treeBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, treeData.size() * sizeof(glm::vec4), treeData.data(), GL_STATIC_DRAW);
+    const std::vector<int> &cellStarts = globalTreeGrid.cellStarts();
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, treeCellBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, cellStarts.size() * sizeof(int), cellStarts.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuFlock::resizeGrid(size_t numCells)
+{
+    // Contagem e início por célula, célula e posição dentro dela por boid
+    size_t gridSize = (2 * numCells + 1 + 2 * numBoids) * sizeof(GLuint);
+    if (numCells != gridCells)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, gridBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, gridSize, nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        gridCells = numCells;
+    }
+}
+
+void GpuFlock::upload(const Flock &flock)
+{
+    if (!isReady())
+        return;
+
+    const std::vector<Boid> &boids = flock.getBoids();
+    numBoids = boids.size();
+    staging.resize(glm::max(numBoids, (size_t)1));
+    cellSize = 25.0f; // raio de separação
+    for (size_t i = 0; i < numBoids; i++)
+    {
+        const Boid &b = boids[i];
+        GpuBoid &g = staging[i];
+        g.position = glm::vec4(b.position, b.wingPhase);
+        g.velocity = glm::vec4(b.velocity, b.maxSpeed);
+        g.prevPosition = glm::vec4(b.prevPosition, b.prevWingPhase);
+        g.prevVelocity = glm::vec4(b.prevVelocity, b.perceptionRadius);
+        g.params = glm::vec4(b.maxForce, b.wingFrequency, b.isObjective ? 1.0f : 0.0f, b.alwaysPerceiveLeader ? 1.0f : 0.0f);
+        cellSize = glm::max(cellSize, b.perceptionRadius);
+    }
+
+    // Os dois buffers do ping-pong com o tamanho novo; o atual recebe os dados
+    current = 0;
+    GLsizeiptr bytes = staging.size() * sizeof(GpuBoid);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, boidBuffers[0]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bytes, staging.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, boidBuffers[1]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bytes, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, sortedBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, 2 * staging.size() * sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    gridCells = 0; // o tamanho da grade depende da quantidade de boids
+
+    uploadTrees();
+
+    // Estatísticas do estado enviado
+    program->Activate();
+    glUniform1ui(numBoidsLoc, (GLuint)numBoids);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boidBuffers[current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, statsBuffer);
+    dispatch(PassStats, GPU_GROUP_SIZE);
+    queueStatsReadback();
+    // Mesmo estado da CPU: a câmera não espera a primeira cópia da GPU
+    stats = flock.getStats();
+}
+
+void GpuFlock::download(std::vector<Boid> &boids)
+{
+    if (!isReady() || boids.size() != numBoids || numBoids == 0)
+        return;
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, boidBuffers[current]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, numBoids * sizeof(GpuBoid), staging.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    for (size_t i = 0; i < numBoids; i++)
+    {
+        const GpuBoid &g = staging[i];
+        Boid &b = boids[i];
+        b.position = glm::vec3(g.position);
+        b.wingPhase = g.position.w;
+        b.velocity = glm::vec3(g.velocity);
+        b.prevPosition = glm::vec3(g.prevPosition);
+        b.prevWingPhase = g.prevPosition.w;
+        b.prevVelocity = glm::vec3(g.prevVelocity);
+        b.acceleration = glm::vec3(0.0f);
+    }
+}
+
+void GpuFlock::download(Flock &flock)
+{
+    download(flock.getBoids());
+    flock.recomputeStats();
+}
+
+void GpuFlock::update(float deltaTime, float boundX, float boundY, float boundZ)
+{
+    TRACE_ZONE("GpuFlock::update");
+    if (!isReady() || numBoids == 0)
+        return;
+
+    // Grade com os mesmos limites e células de Flock::update
+    glm::vec3 minBound(-boundX, 0.0f, -boundZ);
+    glm::vec3 maxBound(boundX, boundY, boundZ);
+    float invCellSize = 1.0f / cellSize;
+    glm::ivec3 dims = glm::max(glm::ivec3(glm::ceil((maxBound - minBound) * invCellSize)), glm::ivec3(1));
+    size_t numCells = (size_t)dims.x * dims.y * dims.z;
+    resizeGrid(numCells);
+
+    program->Activate();
+    glUniform1ui(numBoidsLoc, (GLuint)numBoids);
+    glUniform1ui(numCellsLoc, (GLuint)numCells);
+    program->SetVec3(gridOriginLoc, minBound);
+    program->SetFloat(gridInvCellSizeLoc, invCellSize);
+    glUniform3i(gridDimsLoc, dims.x, dims.y, dims.z);
+    program->SetVec3(boundsLoc, glm::vec3(boundX, boundY, boundZ));
+    program->SetFloat(deltaTimeLoc, deltaTime);
+    glm::vec2 treeOrigin = globalTreeGrid.getOrigin();
+    glm::ivec2 treeDims = globalTreeGrid.getDims();
+    glUniform2f(treeOriginLoc, treeOrigin.x, treeOrigin.y);
+    program->SetFloat(treeInvCellSizeLoc, globalTreeGrid.getInvCellSize());
+    glUniform2i(treeDimsLoc, treeDims.x, treeDims.y);
+    glUniform1ui(numTreesLoc, (GLuint)numTrees);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boidBuffers[current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, boidBuffers[1 - current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gridBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, sortedBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, treeBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, treeCellBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, statsBuffer);
+
+    // Grade por counting sort: contar, somar prefixos, espalhar
+    dispatch(PassClear, (GLuint)numCells);
+    dispatch(PassCount, (GLuint)numBoids);
+    dispatch(PassScan, GPU_GROUP_SIZE);
+    dispatch(PassScatter, (GLuint)numBoids);
+    // Todos leem o buffer atual e escrevem no outro
+    dispatch(PassStep, (GLuint)numBoids);
+    current = 1 - current;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boidBuffers[current]);
+    dispatch(PassStats, GPU_GROUP_SIZE);
+    queueStatsReadback();
+}
+
+// Copia as estatísticas recém-calculadas para a próxima cópia do anel e põe
+// uma cerca atrás; getStats lê a cópia quando a cerca já tiver passado. Uma
+// cópia ainda não lida é sobrescrita (só a mais nova interessa).
+void GpuFlock::queueStatsReadback()
+{
+    int slot = nextReadback;
+    nextReadback = (nextReadback + 1) % GPU_STATS_READBACKS;
+    if (statsFences[slot])
+        glDeleteSync(statsFences[slot]);
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_COPY_READ_BUFFER, statsBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, statsReadbacks[slot]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, 4 * sizeof(glm::vec4));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    statsFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void GpuFlock::dispatchInstances(VBO &instances, size_t count, float alpha, bool wingAnimation)
+{
+    // Realoca (descarta o conteúdo do frame anterior) e escreve na GPU
+    instances.Update(nullptr, count * GPU_INSTANCE_FLOATS * sizeof(float));
+    instances.Unbind();
+
+    glUniform1ui(numBoidsLoc, (GLuint)numBoids);
+    program->SetFloat(alphaLoc, alpha);
+    program->SetInt(wingAnimationLoc, wingAnimation ? 1 : 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boidBuffers[current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, instances.ID);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, drawCommandBuffer);
+    program->SetInt(passLoc, PassInstances);
+    glDispatchCompute(((GLuint)numBoids + GPU_GROUP_SIZE - 1) / GPU_GROUP_SIZE, 1, 1);
+    // O desenho instanciado lê o buffer como atributo de vértice e o
+    // indireto lê a contagem como comando
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+
+void GpuFlock::writeInstances(VBO &instances, float alpha, bool wingAnimation)
+{
+    if (!isReady() || numBoids == 0)
+        return;
+
+    program->Activate();
+    program->SetInt(indirectLoc, 0);
+    dispatchInstances(instances, numBoids, alpha, wingAnimation);
+}
+
+void GpuFlock::writeVisibleInstances(VBO &instances, float alpha, bool wingAnimation, const Frustum *frustum,
+                                     float radius, const LodSelector &lod, const GLuint indexCounts[LOD_LEVELS])
+{
+    if (!isReady())
+        return;
+
+    // Comandos com zero instâncias; o compute shader soma as de cada nível.
+    // baseInstance (GL 4.2) aponta cada comando para a região do seu nível.
+    GLuint commands[LOD_LEVELS][GPU_DRAW_COMMAND_UINTS] = {};
+    for (int level = 0; level < LOD_LEVELS; level++)
+    {
+        commands[level][0] = indexCounts[level];
+        commands[level][4] = (GLuint)(level * numBoids);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawCommandBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(commands), commands);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    if (numBoids == 0)
+        return;
+
+    LodRanges ranges = lod.ranges(radius);
+    program->Activate();
+    program->SetInt(indirectLoc, 1);
+    program->SetInt(cullEnabledLoc, frustum ? 1 : 0);
+    if (frustum)
+        glUniform4fv(frustumPlanesLoc, 6, &frustum->planes[0].x);
+    program->SetFloat(cullRadiusLoc, radius);
+    program->SetVec3(lodCameraLoc, lod.getCameraPosition());
+    glUniform3fv(lodDistanceSqLoc, 1, ranges.distanceSq);
+    dispatchInstances(instances, LOD_LEVELS * numBoids, alpha, wingAnimation);
+}
+
+void GpuFlock::drawIndirect(int level, GLenum mode)
+{
+    if (!isReady())
+        return;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer);
+    glDrawElementsIndirect(mode, GL_UNSIGNED_INT, (const void *)(level * GPU_DRAW_COMMAND_UINTS * sizeof(GLuint)));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+GLuint GpuFlock::readVisibleCount(int level)
+{
+    if (!isReady())
+        return 0;
+    GLuint commands[LOD_LEVELS][GPU_DRAW_COMMAND_UINTS] = {};
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawCommandBuffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(commands), commands);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    if (level >= 0)
+        return commands[level][1];
+    GLuint total = 0;
+    for (int l = 0; l < LOD_LEVELS; l++)
+        total += commands[l][1];
+    return total;
+}
+
+const FlockStats &GpuFlock::getStats()
+{
+    if (!isReady())
+        return stats;
+
+    // Da cópia mais nova para a mais velha: a primeira cuja cerca já passou
+    // é lida sem esperar, e as mais velhas que ela são descartadas
+    for (int age = 1; age <= GPU_STATS_READBACKS; age++)
+    {
+        int slot = (nextReadback - age + GPU_STATS_READBACKS) % GPU_STATS_READBACKS;
+        if (!statsFences[slot])
+            continue;
+        GLenum status = glClientWaitSync(statsFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            continue;
+
+        glm::vec4 values[4];
+        glBindBuffer(GL_COPY_READ_BUFFER, statsReadbacks[slot]);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(values), values);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        stats = statsFromValues(values);
+
+        for (int older = age; older <= GPU_STATS_READBACKS; older++)
+        {
+            int stale = (nextReadback - older + GPU_STATS_READBACKS) % GPU_STATS_READBACKS;
+            if (statsFences[stale])
+                glDeleteSync(statsFences[stale]);
+            statsFences[stale] = nullptr;
+        }
+        break;
+    }
+    return stats;
+}
+
+FlockStats GpuFlock::readStats()
+{
+    if (!isReady())
+        return stats;
+    glm::vec4 values[4];
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(values), values);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return statsFromValues(values);
+}
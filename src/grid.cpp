@@ -0,0 +1,40 @@
+#include "grid.hpp"
+
+SpatialGrid::SpatialGrid() : origin(0.0f), invCellSize(1.0f), dims(1)
+{
+}
+
+void SpatialGrid::build(const std::vector<Boid>& boids, glm::vec3 minBound, glm::vec3 maxBound, float cellSize)
+{
+    origin = minBound;
+    invCellSize = 1.0f / cellSize;
+    dims = glm::max(glm::ivec3(glm::ceil((maxBound - minBound) * invCellSize)), glm::ivec3(1));
+
+    // Os vetores só realocam quando os limites ou a quantidade de boids crescem
+    size_t numCells = (size_t)dims.x * dims.y * dims.z;
+    cellStart.assign(numCells + 1, 0);
+    cellCursor.resize(numCells);
+    boidCell.resize(boids.size());
+    sortedIndices.resize(boids.size());
+
+    // Contar quantos boids caem em cada célula
+    for (size_t i = 0; i < boids.size(); i++)
+    {
+        glm::ivec3 c = cellOf(boids[i].position);
+        boidCell[i] = cellIndex(c.x, c.y, c.z);
+        cellStart[boidCell[i] + 1]++;
+    }
+
+    // Soma de prefixos: cellStart[c] vira o início da célula c
+    for (size_t c = 0; c < numCells; c++)
+    {
+        cellStart[c + 1] += cellStart[c];
+        cellCursor[c] = cellStart[c];
+    }
+
+    // Espalhar os índices mantendo a ordem original dentro de cada célula
+    for (size_t i = 0; i < boids.size(); i++)
+    {
+        sortedIndices[cellCursor[boidCell[i]]++] = (int)i;
+    }
+}
@@ -0,0 +1,38 @@
+#include "lod.hpp"
+#include <cfloat>
+#include <cmath>
+
+LodSelector::LodSelector()
+    : pixelThresholds{64.0f, 24.0f, 6.0f}, enabled(true), cameraPosition(0.0f), pixelsPerUnit(1.0f)
+{
+}
+
+void LodSelector::update(const glm::vec3 &cameraPosition, float fovDegrees, int viewportHeight)
+{
+    this->cameraPosition = cameraPosition;
+    // Meia altura da tela dividida pela meia abertura vertical
+    pixelsPerUnit = 0.5f * (float)viewportHeight / std::tan(glm::radians(fovDegrees) * 0.5f);
+}
+
+LodRanges LodSelector::ranges(float radius) const
+{
+    LodRanges result;
+    for (int l = 0; l < LOD_LEVELS - 1; l++)
+    {
+        // 2r * pixelsPerUnit / d < limite  <=>  d > 2r * pixelsPerUnit / limite
+        float distance = 2.0f * radius * pixelsPerUnit / pixelThresholds[l];
+        result.distanceSq[l] = enabled ? distance * distance : FLT_MAX;
+    }
+    return result;
+}
+
+int LodSelector::select(const glm::vec3 &center, float radius) const
+{
+    glm::vec3 offset = center - cameraPosition;
+    return ranges(radius).select(glm::dot(offset, offset));
+}
+
+const glm::vec3 &LodSelector::getCameraPosition() const
+{
+    return cameraPosition;
+}
@@ -12,7 +12,10 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <cmath>
+#include <cstddef>
 #include <ctime>
+#include <chrono>
+#include <future>
 #include <vector>
 #include <random>
 
@@ -23,13 +26,30 @@
 #include "texture.hpp"
 #include "camera.hpp"
 #include "flock.hpp"
+#include "random.hpp"
+#include "mesh.hpp"
+#include "scene.hpp"
+#include "glCompute.hpp"
+#include "gpuFlock.hpp"
+#include "profiler.hpp"
+#include "textOverlay.hpp"
+#include "trace.hpp"
+#include "frustum.hpp"
+#include "lod.hpp"
+#include <memory>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// Árvores globais para os boids evitarem
-std::vector<Tree> globalTrees;
+// Dados por instância de boid enviados uma vez por frame (locations 4 a 8 do default.vert)
+struct BoidInstance
+{
+    glm::mat4 model;
+    float wingPhase;
+};
+// O compute shader escreve o mesmo layout direto no buffer de instâncias
+static_assert(sizeof(BoidInstance) == GPU_INSTANCE_FLOATS * sizeof(float), "BoidInstance diferente de flock.comp");
 
 class vertex{
     public:
@@ -38,6 +58,162 @@ class vertex{
         int z;
 };
 
+// Resultado de um carregamento feito em outra thread, com o tempo gasto lá
+template <typename T>
+struct LoadedAsset
+{
+    T data;
+    double loadMs;
+};
+
+// Geometria procedural ainda na CPU
+struct GeneratedMesh
+{
+    std::vector<float> v;
+    std::vector<GLuint> e;
+};
+
+// Resolução da grade de decimateMesh para os níveis 1 e 2 dos modelos OBJ
+const int LOD_DECIMATION_RESOLUTION[LOD_IMPOSTOR - 1] = {32, 8};
+// Segmentos do tronco e da copa em cada nível (árvores não têm impostor)
+const int TREE_LOD_SEGMENTS[LOD_IMPOSTOR] = {32, 12, 6};
+
+// Modelo OBJ com as versões simplificadas e o impostor, preparados na thread
+struct ModelLods
+{
+    Mesh full;
+    GeneratedMesh reduced[LOD_IMPOSTOR - 1];
+    GeneratedMesh impostor;
+};
+
+static ModelLods loadModelLods(const std::string &path, float r, float g, float b)
+{
+    ModelLods model;
+    model.full = loadMesh(path, r, g, b);
+    for (int level = 0; level < LOD_IMPOSTOR - 1; level++)
+    {
+        decimateMesh(model.full.vertices(), model.full.vertexCount(), model.full.indices(), model.full.indexCount(),
+                     LOD_DECIMATION_RESOLUTION[level], model.reduced[level].v, model.reduced[level].e);
+    }
+    impostorMesh(model.full.vertices(), model.full.vertexCount(), model.impostor.v, model.impostor.e);
+    return model;
+}
+
+// Malha na GPU com os atributos de vértice ligados (locations 0 a 3)
+struct GpuMesh
+{
+    VAO vao;
+    VBO vbo;
+    EBO ebo;
+    GLsizei indexCount;
+    GLenum mode;
+
+    GpuMesh(const float *vertices, size_t vertexBytes, const GLuint *indices, size_t indexBytes, GLenum mode = GL_TRIANGLES)
+        : vbo(vertices, vertexBytes), ebo(indices, indexBytes), indexCount((GLsizei)(indexBytes / sizeof(GLuint))), mode(mode)
+    {
+        // O EBO só fica associado ao VAO se for ligado com ele ativo
+        vao.Bind();
+        ebo.Bind();
+        vao.LinkAttrib(vbo, 0, 3, GL_FLOAT, 11 * sizeof(float), (void *)0);
+        vao.LinkAttrib(vbo, 1, 3, GL_FLOAT, 11 * sizeof(float), (void *)(3 * sizeof(float)));
+        vao.LinkAttrib(vbo, 2, 2, GL_FLOAT, 11 * sizeof(float), (void *)(6 * sizeof(float)));
+        vao.LinkAttrib(vbo, 3, 3, GL_FLOAT, 11 * sizeof(float), (void *)(8 * sizeof(float)));
+        vao.Unbind();
+        ebo.Unbind();
+    }
+
+    void Delete()
+    {
+        vao.Delete();
+        vbo.Delete();
+        ebo.Delete();
+    }
+};
+
+// Envia os níveis de um modelo: um nível que não tira triângulos do
+// anterior reaproveita a malha dele. Com impostor, levels tem LOD_LEVELS
+// entradas; sem, LOD_IMPOSTOR.
+static void uploadModelLods(const ModelLods &model, bool impostor, std::vector<std::unique_ptr<GpuMesh>> &meshes, GpuMesh **levels)
+{
+    meshes.push_back(std::make_unique<GpuMesh>(model.full.vertices(), model.full.vertexBytes(), model.full.indices(), model.full.indexBytes()));
+    levels[0] = meshes.back().get();
+    for (int level = 1; level < LOD_IMPOSTOR; level++)
+    {
+        const GeneratedMesh &reduced = model.reduced[level - 1];
+        if (reduced.e.empty() || (GLsizei)reduced.e.size() >= levels[level - 1]->indexCount)
+        {
+            levels[level] = levels[level - 1];
+            continue;
+        }
+        meshes.push_back(std::make_unique<GpuMesh>(reduced.v.data(), reduced.v.size() * sizeof(float), reduced.e.data(), reduced.e.size() * sizeof(GLuint)));
+        levels[level] = meshes.back().get();
+    }
+    if (impostor)
+    {
+        meshes.push_back(std::make_unique<GpuMesh>(model.impostor.v.data(), model.impostor.v.size() * sizeof(float),
+                                                   model.impostor.e.data(), model.impostor.e.size() * sizeof(GLuint), GL_POINTS));
+        levels[LOD_IMPOSTOR] = meshes.back().get();
+    }
+}
+
+// Liga o buffer de instâncias ao VAO a partir da instância first. Sem
+// glDrawElementsInstancedBaseInstance no GL 3.3, o deslocamento de cada
+// grupo vai direto nos ponteiros dos atributos.
+static void linkInstances(VAO &vao, VBO &instances, size_t first)
+{
+    vao.Bind();
+    size_t base = first * sizeof(BoidInstance);
+    for (int column = 0; column < 4; column++)
+    {
+        vao.LinkInstanceAttrib(instances, 4 + column, 4, GL_FLOAT, sizeof(BoidInstance), (void *)(base + offsetof(BoidInstance, model) + column * sizeof(glm::vec4)));
+    }
+    vao.LinkInstanceAttrib(instances, 8, 1, GL_FLOAT, sizeof(BoidInstance), (void *)(base + offsetof(BoidInstance, wingPhase)));
+}
+
+// Tempos de inicialização de um asset: leitura na thread, espera da thread
+// principal pelo resultado e envio para a GPU
+struct StartupTiming
+{
+    std::string name;
+    double loadMs;
+    double waitMs;
+    double uploadMs;
+    std::chrono::steady_clock::time_point uploadStart;
+};
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Roda func em uma thread própria e mede quanto ela levou
+template <typename Func>
+auto loadAsync(Func func) -> std::future<LoadedAsset<decltype(func())>>
+{
+    return std::async(std::launch::async, [func]()
+    {
+        auto start = std::chrono::steady_clock::now();
+        LoadedAsset<decltype(func())> asset{func(), 0.0};
+        asset.loadMs = millisecondsSince(start);
+        return asset;
+    });
+}
+
+// Espera o asset ficar pronto e começa a medir o envio dele para a GPU
+template <typename T>
+T waitAsset(std::future<LoadedAsset<T>> &future, std::vector<StartupTiming> &timings, const char *name)
+{
+    auto waitStart = std::chrono::steady_clock::now();
+    LoadedAsset<T> asset = future.get();
+    timings.push_back({name, asset.loadMs, millisecondsSince(waitStart), 0.0, std::chrono::steady_clock::now()});
+    return std::move(asset.data);
+}
+
+static void finishUpload(std::vector<StartupTiming> &timings)
+{
+    timings.back().uploadMs = millisecondsSince(timings.back().uploadStart);
+}
+
 // definir o tamanho da janela
 unsigned int width = 1200;
 unsigned int height = 1200;
@@ -95,123 +271,7 @@ void sierpinskiCreate(std::vector<float> &v, std::vector<int> &e, int it, float
     sierpinskiCreate(v, e, it - 1, x, y + h2 / 2, l2);
 }
 
-void objLoader(std::vector<float> &v, std::vector<int> &e, std::string path, float r = 0.3f, float g = 0.2f, float b = 0.1f)
-{
-    std::ifstream inputFile(path);
-    if (!inputFile.is_open()) {
-        std::cerr << "Erro ao abrir arquivo";
-        return;
-    }
-
-    std::vector<float> positions; // x,y,z
-    std::vector<float> texcoords; // u,v
-    std::vector<float> normals; // x,y,z
-
-    std::string line;
-    while (std::getline(inputFile, line)) {
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
-
-
-        if (prefix == "v") {
-            float x, y, z;
-            iss >> x >> y >> z;
-            positions.push_back(x);
-            positions.push_back(y);
-            positions.push_back(z);
-        }
-        else if (prefix == "vt") {
-            float u, vCoord;
-            iss >> u >> vCoord;
-            texcoords.push_back(u);
-            texcoords.push_back(vCoord);
-        }
-        else if (prefix == "vn") {
-            float x, y, z;
-            iss >> x >> y >> z;
-            normals.push_back(x);
-            normals.push_back(y);
-            normals.push_back(z);
-        }
-        else if (prefix == "f") {
-            // quebrar a linha inteira em tokens
-            std::vector<std::string> tokens;
-            std::string token;
-            std::istringstream fss(line.substr(2)); // ignora "f"
-            while (fss >> token) tokens.push_back(token);
-
-            auto addVertex = [&](std::string t) {
-                int vid = 0, vtid = 0, vnid = 0;
-                // detecta se é v, v/vt, v//vn ou v/vt/vn
-                if (t.find("//") != std::string::npos) {
-                    sscanf(t.c_str(), "%d//%d", &vid, &vnid);
-                }
-                else if (t.find('/') != std::string::npos) {
-                    sscanf(t.c_str(), "%d/%d/%d", &vid, &vtid, &vnid);
-                    if (vtid == 0) sscanf(t.c_str(), "%d/%d", &vid, &vtid);
-                }
-                else {
-                    sscanf(t.c_str(), "%d", &vid);
-                }
-
-                float x=0,y=0,z=0, u=0,vCoord=0;
-                float nx=0, ny=1.0, nz=0; // Normal padrão (aponta para cima)
-
-                if (vid > 0 && (vid-1)*3+2 < (int)positions.size()) {
-                    x = positions[(vid-1)*3+0];
-                    y = positions[(vid-1)*3+1];
-                    z = positions[(vid-1)*3+2];
-                }
-
-                if (vtid > 0 && (vtid-1)*2+1 < (int)texcoords.size()) {
-                    u = texcoords[(vtid-1)*2+0];
-                    vCoord = texcoords[(vtid-1)*2+1];
-                }
-                
-                if (vnid > 0 && (vnid-1)*3+2 < (int)normals.size()) {
-                    nx = normals[(vnid-1)*3+0];
-                    ny = normals[(vnid-1)*3+1];
-                    nz = normals[(vnid-1)*3+2];
-                }
-
-                v.push_back(x);
-                v.push_back(y);
-                v.push_back(z);
-                v.push_back(r);
-                v.push_back(g);
-                v.push_back(b);
-                v.push_back(u);
-                v.push_back(vCoord);
-                v.push_back(nx);
-                v.push_back(ny);
-                v.push_back(nz);
-
-                int newIndex = (v.size()/11) - 1;
-                e.push_back(newIndex);
-            };
-
-            // triangulação: se for triângulo → usa 3 vértices
-            // se for quad → divide em 2 triângulos (0,1,2) e (0,2,3)
-            if (tokens.size() == 3) {
-                addVertex(tokens[0]);
-                addVertex(tokens[1]);
-                addVertex(tokens[2]);
-            }
-            else if (tokens.size() == 4) {
-                addVertex(tokens[0]);
-                addVertex(tokens[1]);
-                addVertex(tokens[2]);
-
-                addVertex(tokens[0]);
-                addVertex(tokens[2]);
-                addVertex(tokens[3]);
-            }
-        }
-    }
-}
-
-void cylinderCreate(std::vector<float> &v, std::vector<int> &e, float x, float y, float z, float r, float h, int it)
+void cylinderCreate(std::vector<float> &v, std::vector<GLuint> &e, float x, float y, float z, float r, float h, int it)
 {
     // Para flat shading, cada face precisa ter seus próprios vértices com normal única
     int baseIndex = v.size() / 11;
@@ -290,7 +350,7 @@ void cylinderCreate(std::vector<float> &v, std::vector<int> &e, float x, float y
     }
 }
 
-void coneCreate(std::vector<float> &v, std::vector<int> &e, float x, float y, float z, float r, float h, int it)
+void coneCreate(std::vector<float> &v, std::vector<GLuint> &e, float x, float y, float z, float r, float h, int it)
 {
     // Para flat shading, cada face precisa ter seus próprios vértices com normal única
     int baseIndex = v.size() / 11;
@@ -348,10 +408,9 @@ void coneCreate(std::vector<float> &v, std::vector<int> &e, float x, float y, fl
     }
 }
 
-void createFloor(std::vector<float> &v, std::vector<int> &e, float x, float y, float z, float scale, float max_h, int max_it)
+void createFloor(std::vector<float> &v, std::vector<GLuint> &e, float x, float y, float z, float scale, float max_h, int max_it)
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen = makeRandomStream(RandomStream::Floor);
     std::uniform_real_distribution<float> heightDist(-max_h, max_h);
     
     float min_x = x - scale/2;
@@ -447,12 +506,116 @@ void createFloor(std::vector<float> &v, std::vector<int> &e, float x, float y, f
 }
 
 
+// Teclas que mexem nos boids pela CPU (Flock::inputs e velocidade do líder);
+// com a simulação na GPU o estado precisa voltar para a CPU antes delas
+static bool flockEditKeyPressed(GLFWwindow *window)
+{
+    const int keys[] = {GLFW_KEY_KP_ADD, GLFW_KEY_KP_MULTIPLY, GLFW_KEY_KP_DIVIDE, GLFW_KEY_KP_SUBTRACT,
+                        GLFW_KEY_UP, GLFW_KEY_DOWN, GLFW_KEY_V};
+    for (int key : keys)
+    {
+        if (glfwGetKey(window, key) == GLFW_PRESS)
+            return true;
+    }
+    return false;
+}
+
 int main(int argc, char *argv[])
 {
+    // Semente global: --seed N reproduz exatamente a mesma cena e trajetórias
+    unsigned int seed = static_cast<unsigned int>(time(nullptr));
+    // Passo fixo da simulação: --sim-hz N ticks por segundo, no máximo
+    // --max-substeps N ticks por quadro (o atraso além disso é descartado)
+    float simulationRate = 60.0f;
+    int maxSubsteps = 5;
+    // Cena: --trees N árvores sorteadas em [-A, A] (--tree-area A)
+    int numTrees = DEFAULT_TREE_COUNT;
+    float treeArea = DEFAULT_TREE_AREA;
+    // --gpu começa com a simulação em compute shaders (tecla G alterna)
+    bool startOnGpu = false;
+    // --profile-csv ARQ grava os tempos de cada quadro (tecla F1 mostra o resumo)
+    std::string profileCsvPath;
+    // --trace ARQ grava zonas desde o início; a tecla T liga a gravação ou,
+    // já ligada, salva os últimos eventos (também salvos ao sair)
+    std::string tracePath = "trace.json";
+    bool startTracing = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--sim-hz" && i + 1 < argc)
+        {
+            simulationRate = glm::max(1.0f, static_cast<float>(std::atof(argv[++i])));
+        }
+        else if (arg == "--max-substeps" && i + 1 < argc)
+        {
+            maxSubsteps = glm::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--trees" && i + 1 < argc)
+        {
+            numTrees = glm::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--tree-area" && i + 1 < argc)
+        {
+            treeArea = glm::max(1.0f, static_cast<float>(std::atof(argv[++i])));
+        }
+        else if (arg == "--gpu")
+        {
+            startOnGpu = true;
+        }
+        else if (arg == "--profile-csv" && i + 1 < argc)
+        {
+            profileCsvPath = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+            startTracing = true;
+        }
+    }
+    setTraceThreadName("principal");
+    setTracingEnabled(startTracing);
+    setGlobalSeed(seed);
+    std::cout << "Semente: " << seed << std::endl;
+    std::cout << "Simulacao: " << simulationRate << " Hz, ate " << maxSubsteps << " passos por quadro" << std::endl;
+
+    // Malhas e imagem são preparadas em threads enquanto a janela e o
+    // contexto OpenGL são criados; o envio para a GPU fica na thread
+    // principal (dona do contexto), logo que cada asset fica pronto
+    auto startupStart = std::chrono::steady_clock::now();
+    std::vector<StartupTiming> startupTimings;
+    std::string texPath = "resource_files/textures/";
+
+    // cylinderCreate(x, y, z, raio, altura, subdivisões), uma vez por nível de detalhe
+    auto cylinderFuture = loadAsync([] {
+        std::vector<GeneratedMesh> levels(LOD_IMPOSTOR);
+        for (int l = 0; l < LOD_IMPOSTOR; l++)
+            cylinderCreate(levels[l].v, levels[l].e, 0.0, 10.0, 0.0, 5, 30, TREE_LOD_SEGMENTS[l]);
+        return levels;
+    });
+    auto coneFuture = loadAsync([] {
+        std::vector<GeneratedMesh> levels(LOD_IMPOSTOR);
+        for (int l = 0; l < LOD_IMPOSTOR; l++)
+            coneCreate(levels[l].v, levels[l].e, 0.0, 30.0, 0.0, 10, 30, TREE_LOD_SEGMENTS[l]);
+        return levels;
+    });
+    // Criar terreno com subdivisão recursiva
+    auto floorFuture = loadAsync([] { GeneratedMesh m; createFloor(m.v, m.e, 0.0f, -5.0f, 0.0f, 3000.0f, 10.0f, 50); return m; });
+    // Modelos OBJ: a partir da segunda execução vêm do cache .mesh mapeado em
+    // memória; as versões simplificadas são geradas na mesma thread
+    auto birdFuture = loadAsync([] { return loadModelLods("resource_files/models/bird.obj", 0.3f, 0.2f, 0.1f); });
+    auto cadeiraFuture = loadAsync([] { return loadModelLods("resource_files/models/cadeira.obj", 0.3f, 0.2f, 0.1f); });
+    auto fuscaFuture = loadAsync([] { return loadModelLods("resource_files/models/fusca.obj", 0.6f, 0.6f, 0.6f); });
+    auto textureFuture = loadAsync([texPath] { return ImageData((texPath + "elephant.png").c_str()); });
+
     // inicia a biblioteca de gerenciamento de tela
     glfwInit();
-    // especifica a versão e tipo do perfil do GLFW e openGL
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    // especifica a versão e tipo do perfil do GLFW e openGL; pede 4.3 para
+    // os compute shaders e cai para 3.3 se o driver não tiver
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     
@@ -482,133 +645,24 @@ int main(int argc, char *argv[])
         4, 6, 7
     };
 
-    std::vector<float> v;
-    std::vector<int> e;
-    
-    // cylinderCreate(x, y, z, raio, altura, subdivisões)
-    cylinderCreate(v,e, 0.0, 10.0, 0.0, 5, 30, 32);
-    GLfloat verticesCylinder[v.size()];
-    GLuint indicesCylinder[e.size()];
-    for (size_t i = 0; i < v.size(); i++)
-    {
-        verticesCylinder[i] = v[i];
-    }
-    for (size_t i = 0; i < e.size(); i++)
-    {
-        indicesCylinder[i] = e[i];
-    }
-    
-    std::vector<float> v_cone;
-    std::vector<int> e_cone;
-    
-    // cylinderCreate(x, y, z, raio, altura, subdivisões)
-    coneCreate(v_cone,e_cone, 0.0, 30.0, 0.0, 10, 30, 32);
-    GLfloat vertices_cone[v_cone.size()];
-    GLuint indices_cone[e_cone.size()];
-    for (size_t i = 0; i < v_cone.size(); i++)
-    {
-        vertices_cone[i] = v_cone[i];
-    }
-    for (size_t i = 0; i < e_cone.size(); i++)
-    {
-        indices_cone[i] = e_cone[i];
-    }
-    
-    std::vector<float> bird_vertices_vec;
-    std::vector<int> bird_indices_vec;
-    objLoader(bird_vertices_vec, bird_indices_vec, "resource_files/models/bird.obj");
-
-    GLfloat bird_vertices[bird_vertices_vec.size()];
-    GLuint bird_indices[bird_indices_vec.size()];
-    for (size_t i = 0; i < bird_vertices_vec.size(); i++)
-    {
-        bird_vertices[i] = bird_vertices_vec[i];
-    }
-    for (size_t i = 0; i < bird_indices_vec.size(); i++)
-    {
-        bird_indices[i] = bird_indices_vec[i];
-    }
-    
-    std::vector<float> cadeira_vertices_vec;
-    std::vector<int> cadeira_indices_vec;
-    objLoader(cadeira_vertices_vec, cadeira_indices_vec, "resource_files/models/cadeira.obj");
-
-    GLfloat cadeira_vertices[cadeira_vertices_vec.size()];
-    GLuint cadeira_indices[cadeira_indices_vec.size()];
-    for (size_t i = 0; i < cadeira_vertices_vec.size(); i++)
-    {
-        cadeira_vertices[i] = cadeira_vertices_vec[i];
-    }
-    for (size_t i = 0; i < cadeira_indices_vec.size(); i++)
-    {
-        cadeira_indices[i] = cadeira_indices_vec[i];
-    }
-    
-    std::vector<float> fusca_vertices_vec;
-    std::vector<int> fusca_indices_vec;
-    objLoader(fusca_vertices_vec, fusca_indices_vec, "resource_files/models/fusca.obj", 0.6f, 0.6f, 0.6f);
-
-    GLfloat fusca_vertices[fusca_vertices_vec.size()];
-    GLuint fusca_indices[fusca_indices_vec.size()];
-    for (size_t i = 0; i < fusca_vertices_vec.size(); i++)
-    {
-        fusca_vertices[i] = fusca_vertices_vec[i];
-    }
-    for (size_t i = 0; i < fusca_indices_vec.size(); i++)
-    {
-        fusca_indices[i] = fusca_indices_vec[i];
-    }
-    
-    std::vector<float> v_plano;
-    std::vector<int> e_plano;
-    
-    // Criar terreno com subdivisão recursiva
-    createFloor(v_plano, e_plano, 0.0f, -5.0f, 0.0f, 3000.0f, 10.0f, 50);
-    
-    GLfloat verticesPlano[v_plano.size()];
-    GLuint indicesPlano[e_plano.size()];
-    for (size_t i = 0; i < v_plano.size(); i++)
-    {
-        verticesPlano[i] = v_plano[i];
-    }
-    for (size_t i = 0; i < e_plano.size(); i++)
-    {
-        indicesPlano[i] = e_plano[i];
-    }
-    
     Flock flock;
     // Adicionar boids
     for (int i = 0; i < 50; i++) {
         flock.add();
     }
     
-    // Criar árvores espalhadas pelo chão
-    std::mt19937 treeGen(static_cast<unsigned int>(time(nullptr)));
-    std::uniform_real_distribution<float> treePosX(-500.0f, 500.0f);
-    std::uniform_real_distribution<float> treePosZ(-500.0f, 500.0f);
-    std::uniform_real_distribution<float> treeRadius(0.5f, 1.0f);
-    std::uniform_real_distribution<float> treeHeight(20.0f, 100.0f);
-    
-    int numTrees = 15;
-    for (int i = 0; i < numTrees; i++) {
-        Tree tree;
-        tree.position = glm::vec3(treePosX(treeGen), -5.0f, treePosZ(treeGen));
-        tree.radius = treeRadius(treeGen);
-        tree.height = treeHeight(treeGen);
-        globalTrees.push_back(tree);
-    }
-    
-    
-    
-    Tree tree;
-    tree.height = 100.0f;
-    tree.radius = 0.5f;
-    tree.position = glm::vec3(0.0f,0.0f,0.0f);
-    globalTrees.push_back(tree);
-
+    // Criar árvores espalhadas pelo chão (mais a árvore central)
+    placeTrees(numTrees, treeArea);
+    std::cout << "Arvores: " << globalTrees.size() << std::endl;
 
     // cria uma janela com GLFW nas dimensões e nome escolhidos
     GLFWwindow *window = glfwCreateWindow(width, height, "helloWorld", NULL, NULL);
+    if (window == NULL)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        window = glfwCreateWindow(width, height, "helloWorld", NULL, NULL);
+    }
 
     if (window == NULL)
     {
@@ -622,8 +676,10 @@ int main(int argc, char *argv[])
     // Definir tamanho mínimo da janela para evitar problemas de aspect ratio
     glfwSetWindowSizeLimits(window, 400, 300, GLFW_DONT_CARE, GLFW_DONT_CARE);
     
-    // carrega o openGL com o glad
+    // carrega o openGL com o glad (e as funções de compute do 4.3, se houver)
     gladLoadGL();
+    bool computeAvailable = loadComputeFunctions((GLADloadproc)glfwGetProcAddress);
+    double windowMs = millisecondsSince(startupStart);
     // delimita o espaço pra desenhar
     glViewport(0, 0, width, height);
     
@@ -653,104 +709,65 @@ int main(int argc, char *argv[])
 
     Shader shaderProgram("resource_files/shaders/default.vert", "resource_files/shaders/default.frag");
 
-    // VAO, VBO, EBO para o cilindro
-    VAO VAO1;
-    VAO1.Bind();
-
-    VBO VBO1(verticesCylinder, sizeof(verticesCylinder));
-    EBO EBO1(indicesCylinder, sizeof(indicesCylinder));
-
-    // linka o VBO com os atributos dos vertices (coordenadas, cores, texturas e normais)
-    VAO1.LinkAttrib(VBO1, 0, 3, GL_FLOAT, 11 * sizeof(float), (void *)0);
-    VAO1.LinkAttrib(VBO1, 1, 3, GL_FLOAT, 11 * sizeof(float), (void *)(3 * sizeof(float)));
-    VAO1.LinkAttrib(VBO1, 2, 2, GL_FLOAT, 11 * sizeof(float), (void *)(6 * sizeof(float)));
-    VAO1.LinkAttrib(VBO1, 3, 3, GL_FLOAT, 11 * sizeof(float), (void *)(8 * sizeof(float)));
-
-    VAO1.Unbind();
-    VBO1.Unbind();
-    EBO1.Unbind();
-    
-    // VAO, VBO, EBO para o cone
-    VAO VAO_cone;
-    VAO_cone.Bind();
-
-    VBO VBO_cone(vertices_cone, sizeof(vertices_cone));
-    EBO EBO_cone(indices_cone, sizeof(indices_cone));
-
-    // linka o VBO com os atributos dos vertices (coordenadas, cores, texturas e normais)
-    VAO_cone.LinkAttrib(VBO_cone, 0, 3, GL_FLOAT, 11 * sizeof(float), (void *)0);
-    VAO_cone.LinkAttrib(VBO_cone, 1, 3, GL_FLOAT, 11 * sizeof(float), (void *)(3 * sizeof(float)));
-    VAO_cone.LinkAttrib(VBO_cone, 2, 2, GL_FLOAT, 11 * sizeof(float), (void *)(6 * sizeof(float)));
-    VAO_cone.LinkAttrib(VBO_cone, 3, 3, GL_FLOAT, 11 * sizeof(float), (void *)(8 * sizeof(float)));
-
-    VAO_cone.Unbind();
-    VBO_cone.Unbind();
-    EBO_cone.Unbind();
-    
-    // VAO, VBO, EBO para o pássaro
-    VAO VAO_bird;
-    VAO_bird.Bind();
-
-    VBO VBO_bird(bird_vertices, sizeof(bird_vertices));
-    EBO EBO_bird(bird_indices, sizeof(bird_indices));
-
-    // linka o VBO com os atributos dos vertices (coordenadas, cores, texturas e normais)
-    VAO_bird.LinkAttrib(VBO_bird, 0, 3, GL_FLOAT, 11 * sizeof(float), (void *)0);
-    VAO_bird.LinkAttrib(VBO_bird, 1, 3, GL_FLOAT, 11 * sizeof(float), (void *)(3 * sizeof(float)));
-    VAO_bird.LinkAttrib(VBO_bird, 2, 2, GL_FLOAT, 11 * sizeof(float), (void *)(6 * sizeof(float)));
-    VAO_bird.LinkAttrib(VBO_bird, 3, 3, GL_FLOAT, 11 * sizeof(float), (void *)(8 * sizeof(float)));
-
-    VAO_bird.Unbind();
-    VBO_bird.Unbind();
-    EBO_bird.Unbind();
-
-    // VAO, VBO, EBO para a cadeira
-    VAO VAO_cadeira;
-    VAO_cadeira.Bind();
-
-    VBO VBO_cadeira(cadeira_vertices, sizeof(cadeira_vertices));
-    EBO EBO_cadeira(cadeira_indices, sizeof(cadeira_indices));
-
-    VAO_cadeira.LinkAttrib(VBO_cadeira, 0, 3, GL_FLOAT, 11 * sizeof(float), (void *)0);
-    VAO_cadeira.LinkAttrib(VBO_cadeira, 1, 3, GL_FLOAT, 11 * sizeof(float), (void *)(3 * sizeof(float)));
-    VAO_cadeira.LinkAttrib(VBO_cadeira, 2, 2, GL_FLOAT, 11 * sizeof(float), (void *)(6 * sizeof(float)));
-    VAO_cadeira.LinkAttrib(VBO_cadeira, 3, 3, GL_FLOAT, 11 * sizeof(float), (void *)(8 * sizeof(float)));
-
-    VAO_cadeira.Unbind();
-    VBO_cadeira.Unbind();
-    EBO_cadeira.Unbind();
-
-    // VAO, VBO, EBO para o fusca
-    VAO VAO_fusca;
-    VAO_fusca.Bind();
-
-    VBO VBO_fusca(fusca_vertices, sizeof(fusca_vertices));
-    EBO EBO_fusca(fusca_indices, sizeof(fusca_indices));
-
-    // linka o VBO com os atributos dos vertices (coordenadas, cores, texturas e normais)
-    VAO_fusca.LinkAttrib(VBO_fusca, 0, 3, GL_FLOAT, 11 * sizeof(float), (void *)0);
-    VAO_fusca.LinkAttrib(VBO_fusca, 1, 3, GL_FLOAT, 11 * sizeof(float), (void *)(3 * sizeof(float)));
-    VAO_fusca.LinkAttrib(VBO_fusca, 2, 2, GL_FLOAT, 11 * sizeof(float), (void *)(6 * sizeof(float)));
-    VAO_fusca.LinkAttrib(VBO_fusca, 3, 3, GL_FLOAT, 11 * sizeof(float), (void *)(8 * sizeof(float)));
-
-    VAO_fusca.Unbind();
-    VBO_fusca.Unbind();
-    EBO_fusca.Unbind();
-
-    // VAO, VBO, EBO para o plano (chão)
-    VAO VAOPlano;
-    VAOPlano.Bind();
-    VBO VBOPlano(verticesPlano, sizeof(verticesPlano));
-    EBO EBOPlano(indicesPlano, sizeof(indicesPlano));
-
-    VAOPlano.LinkAttrib(VBOPlano, 0, 3, GL_FLOAT, 11 * sizeof(float), (void *)0);
-    VAOPlano.LinkAttrib(VBOPlano, 1, 3, GL_FLOAT, 11 * sizeof(float), (void *)(3 * sizeof(float)));
-    VAOPlano.LinkAttrib(VBOPlano, 2, 2, GL_FLOAT, 11 * sizeof(float), (void *)(6 * sizeof(float)));
-    VAOPlano.LinkAttrib(VBOPlano, 3, 3, GL_FLOAT, 11 * sizeof(float), (void *)(8 * sizeof(float)));
+    // Malhas de cada nível de detalhe; os arrays abaixo apontam para elas
+    // (níveis sem redução repetem o ponteiro do anterior)
+    std::vector<std::unique_ptr<GpuMesh>> lodMeshes;
+    GpuMesh *trunkLods[LOD_IMPOSTOR];
+    GpuMesh *crownLods[LOD_IMPOSTOR];
+    GpuMesh *birdLods[LOD_LEVELS];
+    GpuMesh *cadeiraLods[LOD_LEVELS];
+    GpuMesh *fuscaLods[LOD_IMPOSTOR];
+
+    // Tronco (cilindro) e copa (cone) das árvores
+    std::vector<GeneratedMesh> cylinder = waitAsset(cylinderFuture, startupTimings, "cilindro");
+    for (int l = 0; l < LOD_IMPOSTOR; l++)
+    {
+        lodMeshes.push_back(std::make_unique<GpuMesh>(cylinder[l].v.data(), cylinder[l].v.size() * sizeof(float), cylinder[l].e.data(), cylinder[l].e.size() * sizeof(GLuint)));
+        trunkLods[l] = lodMeshes.back().get();
+    }
+    finishUpload(startupTimings);
 
-    VAOPlano.Unbind();
-    VBOPlano.Unbind();
-    EBOPlano.Unbind();
+    std::vector<GeneratedMesh> cone = waitAsset(coneFuture, startupTimings, "cone");
+    for (int l = 0; l < LOD_IMPOSTOR; l++)
+    {
+        lodMeshes.push_back(std::make_unique<GpuMesh>(cone[l].v.data(), cone[l].v.size() * sizeof(float), cone[l].e.data(), cone[l].e.size() * sizeof(GLuint)));
+        crownLods[l] = lodMeshes.back().get();
+    }
+    finishUpload(startupTimings);
+
+    // Pássaro e cadeira: o último nível é o impostor (um ponto)
+    ModelLods birdAsset = waitAsset(birdFuture, startupTimings, "bird.obj");
+    uploadModelLods(birdAsset, true, lodMeshes, birdLods);
+    finishUpload(startupTimings);
+
+    ModelLods cadeiraAsset = waitAsset(cadeiraFuture, startupTimings, "cadeira.obj");
+    uploadModelLods(cadeiraAsset, true, lodMeshes, cadeiraLods);
+    finishUpload(startupTimings);
+
+    // VBO de instâncias, reenviado a cada frame: boids agrupados por nível de
+    // detalhe, cada grupo desenhado com um glDrawElementsInstanced. As
+    // árvores (estáticas, fase 0) usam o mesmo layout em outro VBO.
+    std::vector<BoidInstance> boidInstances;
+    VBO instanceVBO(nullptr, 0, GL_STREAM_DRAW);
+    std::vector<BoidInstance> treeInstances;
+    VBO treeInstanceVBO(nullptr, 0, GL_STREAM_DRAW);
+
+    ModelLods fuscaAsset = waitAsset(fuscaFuture, startupTimings, "fusca.obj");
+    uploadModelLods(fuscaAsset, false, lodMeshes, fuscaLods);
+    finishUpload(startupTimings);
+
+    // Impostores são pontos de alguns pixels
+    glPointSize(3.0f);
+
+    // VAO, VBO, EBO para o plano (chão); depois do envio só a contagem de
+    // índices é usada, então a cópia na CPU é liberada aqui
+    std::unique_ptr<GpuMesh> floorPlane;
+    {
+        GeneratedMesh floorMesh = waitAsset(floorFuture, startupTimings, "terreno");
+        floorPlane = std::make_unique<GpuMesh>(floorMesh.v.data(), floorMesh.v.size() * sizeof(float),
+                                               floorMesh.e.data(), floorMesh.e.size() * sizeof(GLuint));
+    }
+    finishUpload(startupTimings);
 
 
     // VAO, VBO, EBO para o cubo de luz
@@ -797,12 +814,36 @@ int main(int argc, char *argv[])
 
 
     lightShader.Activate();
-    glUniformMatrix4fv(glGetUniformLocation(lightShader.ID, "model"), 1, GL_FALSE, glm::value_ptr(lightModel));
-    glUniform4f(glGetUniformLocation(lightShader.ID, "lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+    lightShader.SetMat4("model", lightModel);
+    lightShader.SetVec4("lightColor", lightColor);
     
     shaderProgram.Activate();
-    glUniform4f(glGetUniformLocation(shaderProgram.ID, "lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
-    glUniform3f(glGetUniformLocation(shaderProgram.ID, "lightPos"), lightPos.x, lightPos.y, lightPos.z);
+    shaderProgram.SetVec4("lightColor", lightColor);
+    shaderProgram.SetVec3("lightPos", lightPos);
+
+    // Volumes para o frustum culling. Boids: esfera da malha na escala 0.5
+    // de Boid::getModelMatrix (vale para qualquer orientação). Árvores,
+    // fusca e luz são estáticos: caixas no mundo calculadas uma vez.
+    float birdRadius = meshRadius(birdAsset.full.vertices(), birdAsset.full.vertexCount(), MESH_FLOATS_PER_VERTEX) * 0.5f;
+    float cadeiraRadius = meshRadius(cadeiraAsset.full.vertices(), cadeiraAsset.full.vertexCount(), MESH_FLOATS_PER_VERTEX) * 0.5f;
+    BoundingBox cylinderBounds = meshBounds(cylinder[0].v.data(), cylinder[0].v.size() / MESH_FLOATS_PER_VERTEX, MESH_FLOATS_PER_VERTEX);
+    BoundingBox coneBounds = meshBounds(cone[0].v.data(), cone[0].v.size() / MESH_FLOATS_PER_VERTEX, MESH_FLOATS_PER_VERTEX);
+    // Tronco e copa usam a mesma matriz. O nível de detalhe dos estáticos
+    // usa a esfera que envolve a caixa (centro e meia diagonal).
+    std::vector<glm::mat4> treeModels;
+    std::vector<BoundingBox> treeBounds;
+    for (const auto& tree : globalTrees)
+    {
+        glm::mat4 treeModel = glm::mat4(1.0f);
+        treeModel = glm::translate(treeModel, tree.position);
+        treeModel = glm::scale(treeModel, glm::vec3(tree.radius + tree.height/80, tree.height /10, tree.radius + tree.height/80));
+        treeModels.push_back(treeModel);
+        treeBounds.push_back(mergeBounds(transformBounds(cylinderBounds, treeModel), transformBounds(coneBounds, treeModel)));
+    }
+    BoundingBox fuscaBounds = transformBounds(meshBounds(fuscaAsset.full.vertices(), fuscaAsset.full.vertexCount(), MESH_FLOATS_PER_VERTEX), fuscaModel);
+    glm::vec3 fuscaCenter = (fuscaBounds.min + fuscaBounds.max) * 0.5f;
+    float fuscaLodRadius = glm::length(fuscaBounds.max - fuscaBounds.min) * 0.5f;
+    BoundingBox lightBounds = transformBounds(meshBounds(lightVertices, 8, 3), lightModel);
 
     // Configurar fog
     bool fogEnabled = false;
@@ -811,28 +852,104 @@ int main(int argc, char *argv[])
     float fogStart = 50.0f;
     float fogEnd = 600.0f;
     
-    glUniform1i(glGetUniformLocation(shaderProgram.ID, "fogEnabled"), fogEnabled);
-    glUniform3f(glGetUniformLocation(shaderProgram.ID, "fogColor"), fogColor.x, fogColor.y, fogColor.z);
-    glUniform1f(glGetUniformLocation(shaderProgram.ID, "fogStart"), fogStart);
-    glUniform1f(glGetUniformLocation(shaderProgram.ID, "fogEnd"), fogEnd);
-
-    // textura
-    std::string texPath = "resource_files/textures/";
-    Texture popCat((texPath + "elephant.png").c_str(), GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    shaderProgram.SetInt("fogEnabled", fogEnabled);
+    shaderProgram.SetVec3("fogColor", fogColor);
+    shaderProgram.SetFloat("fogStart", fogStart);
+    shaderProgram.SetFloat("fogEnd", fogEnd);
+
+    // textura (decodificada na thread, só o envio acontece aqui)
+    ImageData popCatImage = waitAsset(textureFuture, startupTimings, "elephant.png");
+    Texture popCat(popCatImage, GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
     popCat.texUnit(shaderProgram, "tex0", 0);
+    finishUpload(startupTimings);
+
+    // Resumo da inicialização; as leituras correram em paralelo com a janela
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Inicializacao (ms)          leitura    espera     envio" << std::endl;
+    for (const StartupTiming &timing : startupTimings)
+    {
+        std::cout << "  " << std::left << std::setw(24) << timing.name << std::right
+                  << std::setw(9) << timing.loadMs << std::setw(10) << timing.waitMs << std::setw(10) << timing.uploadMs << std::endl;
+    }
+    std::cout << "  janela + contexto GL    " << std::setw(9) << windowMs << std::endl;
+    std::cout << "  total ate o render loop " << std::setw(9) << millisecondsSince(startupStart) << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    bool firstFrame = true;
 
     glEnable(GL_DEPTH_TEST);
 
+    // Localizações dos uniforms usados todo frame, resolvidas uma vez
+    GLint modelLoc = shaderProgram.GetUniformLocation("model");
+    GLint wingPhaseLoc = shaderProgram.GetUniformLocation("wingPhase");
+    GLint instancedLoc = shaderProgram.GetUniformLocation("instanced");
+    GLint camPosLoc = shaderProgram.GetUniformLocation("camPos");
+    GLint fogEnabledLoc = shaderProgram.GetUniformLocation("fogEnabled");
+
     // Variáveis para deltaTime
     float lastTime = glfwGetTime();
     float deltaTime = 0.0f;
+
+    // Acumulador do passo fixo: o tempo real do quadro vira ticks de
+    // simulationStep e a sobra define a interpolação da renderização
+    const float simulationStep = 1.0f / simulationRate;
+    float simulationAccumulator = 0.0f;
     
     // Variáveis de controle
     bool isPaused = false;
     bool useChairModel = false;
 
+    // Simulação em compute shaders: o estado fica na GPU e só volta para a
+    // CPU ao trocar de modo ou quando uma tecla edita os boids
+    GpuFlock gpuFlock;
+    if (computeAvailable && !gpuFlock.init("resource_files/shaders/flock.comp"))
+        std::cout << "Falha ao compilar flock.comp; simulacao so na CPU" << std::endl;
+    bool useGpu = false;
+    if (startOnGpu)
+    {
+        if (gpuFlock.isReady())
+        {
+            gpuFlock.upload(flock);
+            useGpu = true;
+        }
+        else
+        {
+            std::cout << "Simulacao na GPU indisponivel (precisa de OpenGL 4.3)" << std::endl;
+        }
+    }
+    std::cout << "Simulacao: " << (useGpu ? "GPU" : "CPU") << std::endl;
+
+    // Tempos de CPU e GPU por trecho do quadro; o overlay (F1) mostra médias
+    // e percentis, atualizado duas vezes por segundo para continuar legível
+    FrameProfiler profiler;
+    profiler.init();
+    if (!profileCsvPath.empty()) {
+        if (profiler.openCsv(profileCsvPath))
+            std::cout << "Perfil por quadro em " << profileCsvPath << std::endl;
+        else
+            std::cout << "Falha ao abrir " << profileCsvPath << std::endl;
+    }
+    TextOverlay profilerOverlay("resource_files/shaders/overlay.vert", "resource_files/shaders/overlay.frag");
+    bool showProfiler = false;
+    float overlayRefreshTime = 0.0f;
+
+    // Frustum culling (tecla C desliga, para comparar)
+    bool cullingEnabled = true;
+    std::vector<uint32_t> visibleBoids;
+    size_t visibleTrees = 0;
+
+    // Nível de detalhe pelo tamanho na tela (tecla L desliga, para comparar).
+    // Contagens por nível do último quadro, para o overlay.
+    const float cameraFov = 90.0f;
+    LodSelector lod;
+    std::vector<uint8_t> boidLevels;
+    size_t boidLevelCounts[LOD_LEVELS] = {};
+    size_t treeLevelCounts[LOD_IMPOSTOR] = {};
+    std::vector<int> treeLevels;
+
     while (!glfwWindowShouldClose(window))
     {
+        profiler.beginFrame();
+
         // Calcular deltaTime
         float currentTime = glfwGetTime();
         deltaTime = currentTime - lastTime;
@@ -842,7 +959,7 @@ int main(int argc, char *argv[])
         glClearColor(0.6f, 0.7f, 0.70f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        
+        profiler.begin(ProfileSection::Input);
         camera.Inputs(window, deltaTime);
         
         // Toggle fog com tecla F
@@ -851,7 +968,7 @@ int main(int argc, char *argv[])
             if (!fKeyWasPressed) {
                 fogEnabled = !fogEnabled;
                 shaderProgram.Activate();
-                glUniform1i(glGetUniformLocation(shaderProgram.ID, "fogEnabled"), fogEnabled);
+                shaderProgram.SetInt(fogEnabledLoc, fogEnabled);
                 std::cout << "Fog: " << (fogEnabled ? "ligado" : "desligado") << std::endl;
                 fKeyWasPressed = true;
             }
@@ -883,6 +1000,84 @@ int main(int argc, char *argv[])
             mKeyWasPressed = false;
         }
         
+        // Alternar simulação CPU/GPU com tecla G (o estado acompanha a troca)
+        static bool gKeyWasPressed = false;
+        if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS) {
+            if (!gKeyWasPressed) {
+                if (useGpu) {
+                    gpuFlock.download(flock);
+                    useGpu = false;
+                } else if (gpuFlock.isReady()) {
+                    gpuFlock.upload(flock);
+                    useGpu = true;
+                }
+                std::cout << "Simulacao: " << (useGpu ? "GPU" : "CPU") << (gpuFlock.isReady() ? "" : " (GPU indisponivel)") << std::endl;
+                gKeyWasPressed = true;
+            }
+        } else {
+            gKeyWasPressed = false;
+        }
+
+        // Overlay do perfil com tecla F1
+        static bool f1KeyWasPressed = false;
+        if (glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS) {
+            if (!f1KeyWasPressed) {
+                showProfiler = !showProfiler;
+                overlayRefreshTime = 0.0f;
+                f1KeyWasPressed = true;
+            }
+        } else {
+            f1KeyWasPressed = false;
+        }
+
+        // Toggle frustum culling com tecla C
+        static bool cKeyWasPressed = false;
+        if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
+            if (!cKeyWasPressed) {
+                cullingEnabled = !cullingEnabled;
+                std::cout << "Culling: " << (cullingEnabled ? "ligado" : "desligado") << std::endl;
+                cKeyWasPressed = true;
+            }
+        } else {
+            cKeyWasPressed = false;
+        }
+
+        // Toggle níveis de detalhe com tecla L
+        static bool lKeyWasPressed = false;
+        if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
+            if (!lKeyWasPressed) {
+                lod.enabled = !lod.enabled;
+                std::cout << "LOD: " << (lod.enabled ? "ligado" : "desligado") << std::endl;
+                lKeyWasPressed = true;
+            }
+        } else {
+            lKeyWasPressed = false;
+        }
+
+        // Rastreamento com tecla T: liga a gravação ou salva o que já foi gravado
+        static bool tKeyWasPressed = false;
+        if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) {
+            if (!tKeyWasPressed) {
+                if (!tracingEnabled()) {
+                    setTracingEnabled(true);
+                    std::cout << "Trace: gravando (T de novo salva em " << tracePath << ")" << std::endl;
+                } else if (writeTrace(tracePath)) {
+                    std::cout << "Trace salvo em " << tracePath << std::endl;
+                } else {
+                    std::cout << "Falha ao gravar " << tracePath << std::endl;
+                }
+                tKeyWasPressed = true;
+            }
+        } else {
+            tKeyWasPressed = false;
+        }
+
+        // Edições pelo teclado mexem no Flock da CPU: traz o estado da GPU antes
+        bool editingOnGpu = useGpu && flockEditKeyPressed(window);
+        if (editingOnGpu) {
+            gpuFlock.download(flock);
+        }
+        
         // Controlar velocidade do líder (boid objetivo) - alterar módulo
         if (!flock.getBoids().empty() && flock.getBoids()[0].isObjective) {
             Boid& leader = flock.getBoids()[0];
@@ -914,9 +1109,18 @@ int main(int argc, char *argv[])
                 leader.velocity = glm::normalize(leader.velocity) * maxLeaderSpeed;
             }
         }
+
+        flock.inputs(window);
+        if (editingOnGpu) {
+            gpuFlock.upload(flock);
+        }
+        profiler.end(ProfileSection::Input);
         
-        // Passar os boids para a camera
-        camera.updateMatrix(90.0f, 0.1f, 2000.0f, flock);
+        // Passar os boids para a camera (na GPU, estatísticas de um quadro
+        // atrás: getStats não espera os compute shaders)
+        profiler.begin(ProfileSection::Camera);
+        camera.updateMatrix(cameraFov, 0.1f, 2000.0f, useGpu ? gpuFlock.getStats() : flock.getStats());
+        lod.update(camera.Position, cameraFov, camera.height);
         
         //std::cout << "CameraPos:        " << "[" << std::setprecision(2) << camera.Position[0] << " , " << camera.Position[1] << " , " << camera.Position[2] << "]" << "      ";
         //std::cout << "CameraOrientation: " << "[" << std::setprecision(2) << camera.Orientation[0] << " , " << camera.Orientation[1] << " , " << camera.Orientation[2] << "]" << std::endl;
@@ -926,96 +1130,242 @@ int main(int argc, char *argv[])
         camera.Matrix(shaderProgram, "camMatrix");
         
         // Passar posição da câmera para o shader
-        glUniform3f(glGetUniformLocation(shaderProgram.ID, "camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+        shaderProgram.SetVec3(camPosLoc, camera.Position);
         
         // Inicializar wingPhase com valor padrão (0.0) para objetos sem animação
-        glUniform1f(glGetUniformLocation(shaderProgram.ID, "wingPhase"), 0.0f);
+        shaderProgram.SetFloat(wingPhaseLoc, 0.0f);
+
+        profiler.end(ProfileSection::Camera);
 
         // adicinar a textura
+        profiler.begin(ProfileSection::Terrain, true);
         popCat.Bind();
 
         // Desenhar o plano (chão) primeiro
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram.ID, "model"), 1, GL_FALSE, glm::value_ptr(planeModel));
-        VAOPlano.Bind();
-        glDrawElements(GL_TRIANGLES, sizeof(indicesPlano) / sizeof(indicesPlano[0]), GL_UNSIGNED_INT, 0);
+        shaderProgram.SetMat4(modelLoc, planeModel);
+        floorPlane->vao.Bind();
+        glDrawElements(floorPlane->mode, floorPlane->indexCount, GL_UNSIGNED_INT, 0);
         
+        profiler.end(ProfileSection::Terrain);
+
         // Atualizar e desenhar os pássaros (boids)
-        flock.inputs(window);
+        profiler.begin(ProfileSection::Simulation, true);
         if (!isPaused) {
-            flock.update(deltaTime, 600.0f, 200.0f, 600.0f);  // limites X, Y, Z
+            simulationAccumulator += deltaTime;
+            int substeps = 0;
+            while (simulationAccumulator >= simulationStep && substeps < maxSubsteps) {
+                if (useGpu) {
+                    gpuFlock.update(simulationStep, 600.0f, 200.0f, 600.0f);
+                } else {
+                    flock.update(simulationStep, 600.0f, 200.0f, 600.0f);  // limites X, Y, Z
+                }
+                simulationAccumulator -= simulationStep;
+                substeps++;
+            }
+            // Quadro longo demais (janela arrastada, compilação de shader):
+            // a simulação desacelera em vez de tentar alcançar o relógio
+            if (simulationAccumulator >= simulationStep) {
+                simulationAccumulator = std::fmod(simulationAccumulator, simulationStep);
+            }
         }
+        float interpolation = simulationAccumulator / simulationStep;
+        profiler.end(ProfileSection::Simulation);
         
-        // Escolher modelo baseado no modo
-        if (useChairModel) {
-            VAO_cadeira.Bind();
+        profiler.begin(ProfileSection::Boids, true);
+        // Montar as instâncias dos boids visíveis agrupadas por nível de
+        // detalhe e enviar de uma vez (cadeira não tem animação de asas)
+        float boidRadius = useChairModel ? cadeiraRadius : birdRadius;
+        GpuMesh **boidLods = useChairModel ? cadeiraLods : birdLods;
+        size_t numInstances = 0;
+        size_t levelFirst[LOD_LEVELS + 1] = {};
+        if (useGpu) {
+            // O compute shader escreve direto no buffer de instâncias, já
+            // separado por nível, e conta cada nível no seu comando indireto
+            GLuint indexCounts[LOD_LEVELS];
+            for (int level = 0; level < LOD_LEVELS; level++) {
+                indexCounts[level] = (GLuint)boidLods[level]->indexCount;
+            }
+            gpuFlock.writeVisibleInstances(instanceVBO, interpolation, !useChairModel, cullingEnabled ? &camera.frustum : nullptr,
+                                           boidRadius, lod, indexCounts);
+            shaderProgram.Activate();
         } else {
-            VAO_bird.Bind();
-        }
-        for (const auto& boid : flock.getBoids()) {
-            glm::mat4 model = boid.getModelMatrix();
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram.ID, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            
-            // Cadeira não tem animação de asas
-            if (useChairModel) {
-                glUniform1f(glGetUniformLocation(shaderProgram.ID, "wingPhase"), 0.0f);
-                glDrawElements(GL_TRIANGLES, sizeof(cadeira_indices) / sizeof(cadeira_indices[0]), GL_UNSIGNED_INT, 0);
+            const std::vector<Boid>& boids = flock.getBoids();
+            if (cullingEnabled) {
+                flock.cull(camera.frustum, interpolation, boidRadius, visibleBoids);
             } else {
-                glUniform1f(glGetUniformLocation(shaderProgram.ID, "wingPhase"), boid.wingPhase);
-                glDrawElements(GL_TRIANGLES, sizeof(bird_indices) / sizeof(bird_indices[0]), GL_UNSIGNED_INT, 0);
+                visibleBoids.resize(boids.size());
+                for (size_t i = 0; i < boids.size(); i++) {
+                    visibleBoids[i] = (uint32_t)i;
+                }
+            }
+
+            // Ordenação por contagem: nível de cada boid, início de cada
+            // grupo e então as matrizes já na posição final
+            LodRanges boidRanges = lod.ranges(boidRadius);
+            glm::vec3 lodCamera = lod.getCameraPosition();
+            std::fill(boidLevelCounts, boidLevelCounts + LOD_LEVELS, 0);
+            boidLevels.resize(visibleBoids.size());
+            for (size_t k = 0; k < visibleBoids.size(); k++) {
+                const Boid& boid = boids[visibleBoids[k]];
+                glm::vec3 offset = glm::mix(boid.prevPosition, boid.position, interpolation) - lodCamera;
+                boidLevels[k] = (uint8_t)boidRanges.select(glm::dot(offset, offset));
+                boidLevelCounts[boidLevels[k]]++;
+            }
+            size_t levelNext[LOD_LEVELS];
+            for (int level = 0; level < LOD_LEVELS; level++) {
+                levelNext[level] = levelFirst[level];
+                levelFirst[level + 1] = levelFirst[level] + boidLevelCounts[level];
+            }
+            boidInstances.resize(visibleBoids.size());
+            for (size_t k = 0; k < visibleBoids.size(); k++) {
+                const Boid& boid = boids[visibleBoids[k]];
+                boidInstances[levelNext[boidLevels[k]]++] = {boid.getModelMatrix(interpolation), useChairModel ? 0.0f : boid.getWingPhase(interpolation)};
+            }
+            instanceVBO.Update(boidInstances.data(), boidInstances.size() * sizeof(BoidInstance));
+            numInstances = boidInstances.size();
+        }
+
+        // Uma chamada por nível: malha completa, simplificadas e impostores
+        shaderProgram.SetInt(instancedLoc, 1);
+        for (int level = 0; level < LOD_LEVELS; level++) {
+            GpuMesh *mesh = boidLods[level];
+            if (useGpu) {
+                // o baseInstance do comando já aponta para a região do nível
+                linkInstances(mesh->vao, instanceVBO, 0);
+                gpuFlock.drawIndirect(level, mesh->mode);
+            } else if (boidLevelCounts[level] > 0) {
+                linkInstances(mesh->vao, instanceVBO, levelFirst[level]);
+                glDrawElementsInstanced(mesh->mode, mesh->indexCount, GL_UNSIGNED_INT, 0, boidLevelCounts[level]);
             }
         }
+        profiler.end(ProfileSection::Boids);
 
         // Resetar wingPhase para objetos estáticos (cilindro, cone, etc)
-        glUniform1f(glGetUniformLocation(shaderProgram.ID, "wingPhase"), 0.0f);
-
-        // Desenhar todas as árvores
-        for (const auto& tree : globalTrees) {
-            // Desenhar o tronco (cilindro)
-            glm::mat4 trunkModel = glm::mat4(1.0f);
-            trunkModel = glm::translate(trunkModel, tree.position);
-            trunkModel = glm::translate(trunkModel, glm::vec3(0.0f, 0.0f, 0.0f));
-            trunkModel = glm::scale(trunkModel, glm::vec3(tree.radius + tree.height/80, tree.height /10, tree.radius + tree.height/80));
-            
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram.ID, "model"), 1, GL_FALSE, glm::value_ptr(trunkModel));
-            VAO1.Bind();
-            glDrawElements(GL_TRIANGLES, sizeof(indicesCylinder) / sizeof(indicesCylinder[0]), GL_UNSIGNED_INT, 0);
-            
-            // Desenhar a copa (cone)
-            glm::mat4 foliageModel = glm::mat4(1.0f);
-            foliageModel = glm::translate(foliageModel, tree.position);
-            foliageModel = glm::translate(foliageModel, glm::vec3(0.0f, 0.0f, 0.0f));
-            foliageModel = glm::scale(foliageModel, glm::vec3(tree.radius + tree.height/80, tree.height /10, tree.radius + tree.height/80));
-            
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram.ID, "model"), 1, GL_FALSE, glm::value_ptr(foliageModel));
-            VAO_cone.Bind();
-            glDrawElements(GL_TRIANGLES, sizeof(indices_cone) / sizeof(indices_cone[0]), GL_UNSIGNED_INT, 0);
+        shaderProgram.SetFloat(wingPhaseLoc, 0.0f);
+
+        // Árvores dentro do frustum, agrupadas por nível de detalhe: tronco e
+        // copa de um nível saem em duas chamadas instanciadas
+        profiler.begin(ProfileSection::Trees, true);
+        visibleTrees = 0;
+        std::fill(treeLevelCounts, treeLevelCounts + LOD_IMPOSTOR, 0);
+        treeLevels.assign(treeModels.size(), -1);
+        for (size_t t = 0; t < treeModels.size(); t++) {
+            if (cullingEnabled && !camera.frustum.intersectsBox(treeBounds[t])) {
+                continue;
+            }
+            glm::vec3 center = (treeBounds[t].min + treeBounds[t].max) * 0.5f;
+            float radius = glm::length(treeBounds[t].max - treeBounds[t].min) * 0.5f;
+            treeLevels[t] = std::min(lod.select(center, radius), LOD_IMPOSTOR - 1);
+            treeLevelCounts[treeLevels[t]]++;
+            visibleTrees++;
+        }
+        size_t treeFirst[LOD_IMPOSTOR + 1] = {};
+        size_t treeNext[LOD_IMPOSTOR];
+        for (int level = 0; level < LOD_IMPOSTOR; level++) {
+            treeNext[level] = treeFirst[level];
+            treeFirst[level + 1] = treeFirst[level] + treeLevelCounts[level];
+        }
+        treeInstances.resize(visibleTrees);
+        for (size_t t = 0; t < treeModels.size(); t++) {
+            if (treeLevels[t] >= 0) {
+                treeInstances[treeNext[treeLevels[t]]++] = {treeModels[t], 0.0f};
+            }
+        }
+        if (visibleTrees > 0) {
+            treeInstanceVBO.Update(treeInstances.data(), treeInstances.size() * sizeof(BoidInstance));
+            for (int level = 0; level < LOD_IMPOSTOR; level++) {
+                if (treeLevelCounts[level] == 0) {
+                    continue;
+                }
+                for (GpuMesh *mesh : {trunkLods[level], crownLods[level]}) {
+                    linkInstances(mesh->vao, treeInstanceVBO, treeFirst[level]);
+                    glDrawElementsInstanced(GL_TRIANGLES, mesh->indexCount, GL_UNSIGNED_INT, 0, treeLevelCounts[level]);
+                }
+            }
         }
+        shaderProgram.SetInt(instancedLoc, 0);
+        profiler.end(ProfileSection::Trees);
         
-        // Desenhar o fusca
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram.ID, "model"), 1, GL_FALSE, glm::value_ptr(fuscaModel));
-        VAO_fusca.Bind();
-        glDrawElements(GL_TRIANGLES, sizeof(fusca_indices) / sizeof(fusca_indices[0]), GL_UNSIGNED_INT, 0);
+        // Desenhar o fusca no nível que cabe ao tamanho dele na tela
+        profiler.begin(ProfileSection::Fusca, true);
+        if (!cullingEnabled || camera.frustum.intersectsBox(fuscaBounds)) {
+            GpuMesh *mesh = fuscaLods[std::min(lod.select(fuscaCenter, fuscaLodRadius), LOD_IMPOSTOR - 1)];
+            shaderProgram.SetMat4(modelLoc, fuscaModel);
+            mesh->vao.Bind();
+            glDrawElements(GL_TRIANGLES, mesh->indexCount, GL_UNSIGNED_INT, 0);
+        }
+        profiler.end(ProfileSection::Fusca);
         
         // Desenhar a luz
-        lightShader.Activate();
-        camera.Matrix(lightShader, "camMatrix");
-        lightVAO.Bind();
-        glDrawElements(GL_TRIANGLES, sizeof(lightIndices) / sizeof(lightIndices[0]), GL_UNSIGNED_INT, 0);
-
+        profiler.begin(ProfileSection::Light, true);
+        if (!cullingEnabled || camera.frustum.intersectsBox(lightBounds)) {
+            lightShader.Activate();
+            camera.Matrix(lightShader, "camMatrix");
+            lightVAO.Bind();
+            glDrawElements(GL_TRIANGLES, sizeof(lightIndices) / sizeof(lightIndices[0]), GL_UNSIGNED_INT, 0);
+        }
+        profiler.end(ProfileSection::Light);
+
+        // Resumo do perfil por cima de tudo
+        if (showProfiler) {
+            profiler.begin(ProfileSection::Overlay, true);
+            if (currentTime >= overlayRefreshTime) {
+                // Boids visíveis na GPU ficam só nos comandos indiretos
+                std::string boidsVisible = useGpu ? "-" : std::to_string(numInstances);
+                std::string boidLevelText = "-";
+                if (!useGpu) {
+                    boidLevelText = std::to_string(boidLevelCounts[0]);
+                    for (int level = 1; level < LOD_LEVELS; level++) {
+                        boidLevelText += "/" + std::to_string(boidLevelCounts[level]);
+                    }
+                }
+                std::string treeLevelText = std::to_string(treeLevelCounts[0]);
+                for (int level = 1; level < LOD_IMPOSTOR; level++) {
+                    treeLevelText += "/" + std::to_string(treeLevelCounts[level]);
+                }
+                profilerOverlay.SetText(profiler.report() + "VISIVEIS: BOIDS " + boidsVisible + "/" +
+                                        std::to_string(useGpu ? gpuFlock.size() : flock.size()) + "  ARVORES " +
+                                        std::to_string(visibleTrees) + "/" + std::to_string(treeModels.size()) +
+                                        (cullingEnabled ? "" : "  (CULLING DESLIGADO)") + "\n" +
+                                        "NIVEIS: BOIDS " + boidLevelText + "  ARVORES " + treeLevelText +
+                                        (lod.enabled ? "" : "  (LOD DESLIGADO)") + "\n");
+                overlayRefreshTime = currentTime + 0.5f;
+            }
+            profilerOverlay.Draw(camera.width, camera.height);
+            profiler.end(ProfileSection::Overlay);
+        }
 
+        profiler.begin(ProfileSection::Swap);
         glfwSwapBuffers(window);
+        if (firstFrame)
+        {
+            std::cout << "Primeiro frame em " << millisecondsSince(startupStart) << " ms" << std::endl;
+            firstFrame = false;
+        }
 
         // processar todos os eventos da tela
         glfwPollEvents();
+        profiler.end(ProfileSection::Swap);
+        profiler.endFrame();
+    }
+
+    // Fora do laço as threads do pool estão paradas: o dump é seguro
+    if (tracingEnabled()) {
+        setTracingEnabled(false);
+        if (writeTrace(tracePath))
+            std::cout << "Trace salvo em " << tracePath << std::endl;
     }
 
     // deletar tudo
-    VAO1.Delete();
-    VBO1.Delete();
-    EBO1.Delete();
-    VAOPlano.Delete();
-    VBOPlano.Delete();
-    EBOPlano.Delete();
+    for (auto &mesh : lodMeshes) {
+        mesh->Delete();
+    }
+    floorPlane->Delete();
+    instanceVBO.Delete();
+    treeInstanceVBO.Delete();
+    gpuFlock.Delete();
+    profilerOverlay.Delete();
+    profiler.Delete();
     shaderProgram.Delete();
     glfwDestroyWindow(window);
     popCat.Delete();
@@ -0,0 +1,828 @@
+#include "mesh.hpp"
+#include "trace.hpp"
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Formato do cache: cabeçalho fixo seguido dos vértices (vertexCount * 11
+// floats) e dos índices (indexCount * uint32), na ordem de bytes da máquina
+// que gerou o arquivo. Mudou o layout? Incrementar MESH_CACHE_VERSION.
+static const char MESH_CACHE_MAGIC[4] = {'B', 'M', 'S', 'H'};
+static const uint32_t MESH_CACHE_VERSION = 2;
+static const uint32_t MESH_CACHE_OPTIMIZED = 1; // índices reordenados para o cache de vértices
+
+struct MeshCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t floatsPerVertex;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t flags;
+    float color[3];
+    uint32_t reserved;
+    uint64_t sourceSize; // tamanho e data do OBJ de origem, para detectar cache velho
+    int64_t sourceTime;
+};
+static_assert(sizeof(MeshCacheHeader) == 56, "cabeçalho do cache deve ter layout fixo");
+
+Mesh::Mesh()
+{
+}
+
+Mesh::~Mesh()
+{
+    unmap();
+}
+
+Mesh::Mesh(Mesh &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+Mesh &Mesh::operator=(Mesh &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    unmap();
+    ownedVertices = std::move(other.ownedVertices);
+    ownedIndices = std::move(other.ownedIndices);
+    vertexPtr = other.vertexPtr;
+    indexPtr = other.indexPtr;
+    numVertices = other.numVertices;
+    numIndices = other.numIndices;
+    mapping = other.mapping;
+    mappingSize = other.mappingSize;
+#ifdef _WIN32
+    mappingHandle = other.mappingHandle;
+    other.mappingHandle = nullptr;
+#endif
+
+    other.vertexPtr = nullptr;
+    other.indexPtr = nullptr;
+    other.numVertices = 0;
+    other.numIndices = 0;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+    return *this;
+}
+
+const float *Mesh::vertices() const
+{
+    return vertexPtr;
+}
+
+const uint32_t *Mesh::indices() const
+{
+    return indexPtr;
+}
+
+size_t Mesh::vertexCount() const
+{
+    return numVertices;
+}
+
+size_t Mesh::indexCount() const
+{
+    return numIndices;
+}
+
+size_t Mesh::vertexBytes() const
+{
+    return numVertices * MESH_FLOATS_PER_VERTEX * sizeof(float);
+}
+
+size_t Mesh::indexBytes() const
+{
+    return numIndices * sizeof(uint32_t);
+}
+
+bool Mesh::isMapped() const
+{
+    return mapping != nullptr;
+}
+
+void Mesh::assign(std::vector<float> &&vertexData, std::vector<uint32_t> &&indexData)
+{
+    unmap();
+    ownedVertices = std::move(vertexData);
+    ownedIndices = std::move(indexData);
+    vertexPtr = ownedVertices.data();
+    indexPtr = ownedIndices.data();
+    numVertices = ownedVertices.size() / MESH_FLOATS_PER_VERTEX;
+    numIndices = ownedIndices.size();
+}
+
+bool Mesh::mapCache(const std::string &cachePath, uint64_t sourceSize, int64_t sourceTime, const float color[3], bool optimized)
+{
+    unmap();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(MeshCacheHeader))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (handle == NULL)
+        return false;
+    void *view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL)
+    {
+        CloseHandle(handle);
+        return false;
+    }
+    mapping = view;
+    mappingHandle = handle;
+    mappingSize = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(cachePath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(MeshCacheHeader))
+    {
+        close(fd);
+        return false;
+    }
+    void *view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+    mapping = view;
+    mappingSize = (size_t)info.st_size;
+#endif
+
+    const MeshCacheHeader *header = static_cast<const MeshCacheHeader *>(mapping);
+    size_t expected = sizeof(MeshCacheHeader) +
+                      (size_t)header->vertexCount * MESH_FLOATS_PER_VERTEX * sizeof(float) +
+                      (size_t)header->indexCount * sizeof(uint32_t);
+    bool valid = std::memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) == 0 &&
+                 header->version == MESH_CACHE_VERSION &&
+                 header->floatsPerVertex == (uint32_t)MESH_FLOATS_PER_VERTEX &&
+                 header->flags == (optimized ? MESH_CACHE_OPTIMIZED : 0u) &&
+                 header->sourceSize == sourceSize &&
+                 header->sourceTime == sourceTime &&
+                 header->color[0] == color[0] && header->color[1] == color[1] && header->color[2] == color[2] &&
+                 mappingSize == expected;
+    if (!valid)
+    {
+        unmap();
+        return false;
+    }
+
+    const char *data = static_cast<const char *>(mapping) + sizeof(MeshCacheHeader);
+    vertexPtr = reinterpret_cast<const float *>(data);
+    indexPtr = reinterpret_cast<const uint32_t *>(data + (size_t)header->vertexCount * MESH_FLOATS_PER_VERTEX * sizeof(float));
+    numVertices = header->vertexCount;
+    numIndices = header->indexCount;
+    ownedVertices.clear();
+    ownedIndices.clear();
+    return true;
+}
+
+void Mesh::unmap()
+{
+    if (mapping == nullptr)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(mappingHandle);
+    mappingHandle = nullptr;
+#else
+    munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    vertexPtr = nullptr;
+    indexPtr = nullptr;
+    numVertices = 0;
+    numIndices = 0;
+}
+
+// Tripla de índices de um canto de face no OBJ (já resolvidos, -1 = ausente)
+struct VertexKey
+{
+    int v, vt, vn;
+};
+
+// Leitura do OBJ: o arquivo inteiro vai para um buffer e é percorrido com
+// um cursor; números saem direto do buffer via std::from_chars, sem
+// strings nem streams por linha
+
+static inline void skipSpaces(const char *&p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+}
+
+static inline void skipLine(const char *&p, const char *end)
+{
+    const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    p = newline ? newline + 1 : end;
+}
+
+static inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline bool parseFloat(const char *&p, const char *end, float &value)
+{
+    skipSpaces(p, end);
+    if (p < end && *p == '+')
+        p++;
+
+    // Caminho rápido para o formato que os exportadores usam ("-14.372906"):
+    // até 15 dígitos sem expoente cabem exatos em um double e uma divisão
+    // por potência de 10 exata dá o valor certo; o resto vai para from_chars
+    static const double powersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+                                        1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    const char *q = p;
+    bool negative = (q < end && *q == '-');
+    if (negative)
+        q++;
+    uint64_t mantissa = 0;
+    int digits = 0, fractionDigits = 0;
+    while (q < end && isDigit(*q))
+    {
+        mantissa = mantissa * 10 + (*q++ - '0');
+        digits++;
+    }
+    if (q < end && *q == '.')
+    {
+        q++;
+        while (q < end && isDigit(*q))
+        {
+            mantissa = mantissa * 10 + (*q++ - '0');
+            digits++;
+            fractionDigits++;
+        }
+    }
+    if (digits > 0 && digits <= 15 && (q >= end || (*q != 'e' && *q != 'E')))
+    {
+        double result = (double)mantissa / powersOf10[fractionDigits];
+        value = (float)(negative ? -result : result);
+        p = q;
+        return true;
+    }
+
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc())
+        return false;
+    p = result.ptr;
+    return true;
+}
+
+static inline bool parseInt(const char *&p, const char *end, int &value)
+{
+    if (p < end && *p == '+')
+        p++;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc())
+        return false;
+    p = result.ptr;
+    return true;
+}
+
+// Índices do OBJ começam em 1; negativos contam a partir do último elemento
+// já lido. Devolve -1 quando ausente ou fora do intervalo.
+static inline int resolveIndex(int index, size_t count)
+{
+    if (index > 0)
+        return (size_t)index <= count ? index - 1 : -1;
+    if (index < 0)
+        return (size_t)(-(long long)index) <= count ? (int)(count + index) : -1;
+    return -1;
+}
+
+bool objLoader(std::vector<float> &v, std::vector<uint32_t> &e, const std::string &path, float r, float g, float b)
+{
+    TRACE_ZONE("objLoader");
+    std::ifstream inputFile(path, std::ios::binary | std::ios::ate);
+    if (!inputFile.is_open()) {
+        std::cerr << "Erro ao abrir arquivo " << path << std::endl;
+        return false;
+    }
+    std::vector<char> buffer((size_t)inputFile.tellg());
+    inputFile.seekg(0);
+    inputFile.read(buffer.data(), buffer.size());
+    const char *const begin = buffer.data();
+    const char *const end = begin + buffer.size();
+
+    // Primeira passada só conta as linhas para reservar tudo de uma vez
+    size_t numPositions = 0, numTexcoords = 0, numNormals = 0, numFaces = 0;
+    for (const char *p = begin; p < end; skipLine(p, end))
+    {
+        skipSpaces(p, end);
+        if (end - p < 2)
+            break;
+        if (p[0] == 'v' && p[1] == ' ')
+            numPositions++;
+        else if (p[0] == 'v' && p[1] == 't')
+            numTexcoords++;
+        else if (p[0] == 'v' && p[1] == 'n')
+            numNormals++;
+        else if (p[0] == 'f' && p[1] == ' ')
+            numFaces++;
+    }
+
+    std::vector<float> positions; // x,y,z
+    std::vector<float> texcoords; // u,v
+    std::vector<float> normals; // x,y,z
+    positions.reserve(numPositions * 3);
+    texcoords.reserve(numTexcoords * 2);
+    normals.reserve(numNormals * 3);
+    v.reserve(v.size() + numPositions * MESH_FLOATS_PER_VERTEX);
+    e.reserve(e.size() + numFaces * 6);
+
+    // Vértices já emitidos, encadeados pelo índice de posição: cada posição
+    // costuma ter poucas combinações (vt, vn), então a busca é curta e não
+    // há alocação por vértice como num unordered_map. O último balde é para
+    // cantos sem posição válida.
+    const uint32_t baseIndex = v.size() / MESH_FLOATS_PER_VERTEX;
+    std::vector<int> firstWithPosition(numPositions + 1, -1);
+    std::vector<int> nextWithPosition;
+    std::vector<VertexKey> emittedKeys;
+    nextWithPosition.reserve(numFaces * 3);
+    emittedKeys.reserve(numFaces * 3);
+
+    // cantos da face atual, reaproveitado entre faces
+    std::vector<uint32_t> corners;
+
+    auto addVertex = [&](VertexKey key) -> uint32_t {
+        int &bucket = firstWithPosition[key.v >= 0 ? key.v : numPositions];
+        for (int i = bucket; i >= 0; i = nextWithPosition[i]) {
+            if (emittedKeys[i].vt == key.vt && emittedKeys[i].vn == key.vn)
+                return baseIndex + i;
+        }
+
+        float x=0,y=0,z=0, u=0,vCoord=0;
+        float nx=0, ny=1.0, nz=0; // Normal padrão (aponta para cima)
+
+        if (key.v >= 0) {
+            x = positions[key.v*3+0];
+            y = positions[key.v*3+1];
+            z = positions[key.v*3+2];
+        }
+
+        if (key.vt >= 0) {
+            u = texcoords[key.vt*2+0];
+            vCoord = texcoords[key.vt*2+1];
+        }
+
+        if (key.vn >= 0) {
+            nx = normals[key.vn*3+0];
+            ny = normals[key.vn*3+1];
+            nz = normals[key.vn*3+2];
+        }
+
+        const float vertex[MESH_FLOATS_PER_VERTEX] = {x, y, z, r, g, b, u, vCoord, nx, ny, nz};
+        v.insert(v.end(), vertex, vertex + MESH_FLOATS_PER_VERTEX);
+
+        uint32_t newIndex = (v.size()/11) - 1;
+        nextWithPosition.push_back(bucket);
+        emittedKeys.push_back(key);
+        bucket = (int)(newIndex - baseIndex);
+        return newIndex;
+    };
+
+    for (const char *p = begin; p < end; skipLine(p, end))
+    {
+        skipSpaces(p, end);
+        if (end - p < 2)
+            break;
+
+        if (p[0] == 'v' && p[1] == ' ') {
+            p += 1;
+            float x = 0, y = 0, z = 0;
+            parseFloat(p, end, x) && parseFloat(p, end, y) && parseFloat(p, end, z);
+            positions.push_back(x);
+            positions.push_back(y);
+            positions.push_back(z);
+        }
+        else if (p[0] == 'v' && p[1] == 't') {
+            p += 2;
+            float u = 0, vCoord = 0;
+            parseFloat(p, end, u) && parseFloat(p, end, vCoord);
+            texcoords.push_back(u);
+            texcoords.push_back(vCoord);
+        }
+        else if (p[0] == 'v' && p[1] == 'n') {
+            p += 2;
+            float x = 0, y = 0, z = 0;
+            parseFloat(p, end, x) && parseFloat(p, end, y) && parseFloat(p, end, z);
+            normals.push_back(x);
+            normals.push_back(y);
+            normals.push_back(z);
+        }
+        else if (p[0] == 'f' && p[1] == ' ') {
+            p += 1;
+            corners.clear();
+            // cada canto é v, v/vt, v//vn ou v/vt/vn
+            while (true) {
+                skipSpaces(p, end);
+                int vid = 0, vtid = 0, vnid = 0;
+                if (!parseInt(p, end, vid))
+                    break;
+                if (p < end && *p == '/') {
+                    p++;
+                    if (p < end && *p != '/')
+                        parseInt(p, end, vtid);
+                    if (p < end && *p == '/') {
+                        p++;
+                        parseInt(p, end, vnid);
+                    }
+                }
+                VertexKey key = {resolveIndex(vid, positions.size() / 3),
+                                 resolveIndex(vtid, texcoords.size() / 2),
+                                 resolveIndex(vnid, normals.size() / 3)};
+                corners.push_back(addVertex(key));
+            }
+
+            // triangulação em leque: (0,1,2), (0,2,3), ... cobre tris, quads e n-gons convexos
+            for (size_t i = 2; i < corners.size(); i++) {
+                e.push_back(corners[0]);
+                e.push_back(corners[i - 1]);
+                e.push_back(corners[i]);
+            }
+        }
+    }
+    return true;
+}
+
+// Grava o cache em um arquivo temporário e troca no final, para que uma
+// execução interrompida nunca deixe um .mesh pela metade
+static void writeMeshCache(const std::string &cachePath, const std::vector<float> &v, const std::vector<uint32_t> &e,
+                           uint64_t sourceSize, int64_t sourceTime, const float color[3], bool optimized)
+{
+    MeshCacheHeader header;
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.floatsPerVertex = MESH_FLOATS_PER_VERTEX;
+    header.vertexCount = (uint32_t)(v.size() / MESH_FLOATS_PER_VERTEX);
+    header.indexCount = (uint32_t)e.size();
+    header.flags = optimized ? MESH_CACHE_OPTIMIZED : 0u;
+    header.reserved = 0;
+    header.color[0] = color[0];
+    header.color[1] = color[1];
+    header.color[2] = color[2];
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return; // pasta somente leitura: segue sem cache
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(v.data()), header.vertexCount * MESH_FLOATS_PER_VERTEX * sizeof(float));
+        out.write(reinterpret_cast<const char *>(e.data()), e.size() * sizeof(uint32_t));
+        if (!out)
+        {
+            out.close();
+            std::remove(tempPath.c_str());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::remove(cachePath, error);
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error)
+        std::filesystem::remove(tempPath, error);
+}
+
+// Pontuação de um vértice no algoritmo de Forsyth ("Linear-Speed Vertex
+// Cache Optimisation"): favorece vértices recém usados e os que têm poucos
+// triângulos restantes, para terminar regiões antes de saltar para outra
+static const int FORSYTH_CACHE_SIZE = 32;
+
+static float forsythVertexScore(int cachePosition, int remainingTriangles)
+{
+    if (remainingTriangles == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3)
+            score = 0.75f; // vértices do triângulo que acabou de sair
+        else
+        {
+            float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scale, 1.5f);
+        }
+    }
+    score += 2.0f * std::pow((float)remainingTriangles, -0.5f);
+    return score;
+}
+
+void optimizeVertexCache(std::vector<uint32_t> &e, size_t vertexCount)
+{
+    size_t numTriangles = e.size() / 3;
+    if (numTriangles == 0)
+        return;
+
+    // Triângulos de cada vértice em listas contíguas; os ainda não emitidos
+    // ficam em [adjacencyStart[v], adjacencyStart[v] + remaining[v])
+    std::vector<int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < numTriangles * 3; i++)
+        remaining[e[i]]++;
+    std::vector<int> adjacencyStart(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+    std::vector<int> adjacency(numTriangles * 3);
+    std::vector<int> cursor(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (size_t t = 0; t < numTriangles; t++)
+        for (int k = 0; k < 3; k++)
+            adjacency[cursor[e[t * 3 + k]]++] = (int)t;
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+        vertexScore[v] = forsythVertexScore(-1, remaining[v]);
+
+    std::vector<char> emitted(numTriangles, 0);
+    std::vector<uint32_t> output;
+    output.reserve(numTriangles * 3);
+    std::vector<uint32_t> cache, newCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    int bestTriangle = -1;
+    size_t scanCursor = 0;
+    for (size_t n = 0; n < numTriangles; n++)
+    {
+        // Nenhum candidato no cache (nova região): segue pelo próximo não emitido
+        if (bestTriangle < 0)
+        {
+            while (emitted[scanCursor])
+                scanCursor++;
+            bestTriangle = (int)scanCursor;
+        }
+
+        int t = bestTriangle;
+        emitted[t] = 1;
+        newCache.clear();
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t vertex = e[t * 3 + k];
+            output.push_back(vertex);
+            newCache.push_back(vertex);
+
+            int begin = adjacencyStart[vertex];
+            int end = begin + remaining[vertex];
+            for (int a = begin; a < end; a++)
+            {
+                if (adjacency[a] == t)
+                {
+                    std::swap(adjacency[a], adjacency[end - 1]);
+                    break;
+                }
+            }
+            remaining[vertex]--;
+        }
+
+        // LRU: o triângulo emitido vai para a frente, o resto desliza
+        for (uint32_t vertex : cache)
+        {
+            if (vertex != newCache[0] && vertex != newCache[1] && vertex != newCache[2])
+                newCache.push_back(vertex);
+        }
+        for (size_t i = 0; i < newCache.size(); i++)
+        {
+            uint32_t vertex = newCache[i];
+            cachePosition[vertex] = (i < (size_t)FORSYTH_CACHE_SIZE) ? (int)i : -1;
+            vertexScore[vertex] = forsythVertexScore(cachePosition[vertex], remaining[vertex]);
+        }
+
+        // Só os triângulos que tocam o cache mudaram de pontuação
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (uint32_t vertex : newCache)
+        {
+            int begin = adjacencyStart[vertex];
+            int end = begin + remaining[vertex];
+            for (int a = begin; a < end; a++)
+            {
+                int candidate = adjacency[a];
+                float score = vertexScore[e[candidate * 3]] + vertexScore[e[candidate * 3 + 1]] + vertexScore[e[candidate * 3 + 2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = candidate;
+                }
+            }
+        }
+
+        if (newCache.size() > (size_t)FORSYTH_CACHE_SIZE)
+            newCache.resize(FORSYTH_CACHE_SIZE);
+        cache.swap(newCache);
+    }
+
+    e.swap(output);
+}
+
+void reorderVertices(std::vector<float> &v, std::vector<uint32_t> &e)
+{
+    size_t vertexCount = v.size() / MESH_FLOATS_PER_VERTEX;
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    std::vector<float> reordered;
+    reordered.reserve(v.size());
+
+    uint32_t next = 0;
+    for (uint32_t &index : e)
+    {
+        if (remap[index] == UINT32_MAX)
+        {
+            remap[index] = next++;
+            reordered.insert(reordered.end(), v.begin() + (size_t)index * MESH_FLOATS_PER_VERTEX,
+                             v.begin() + ((size_t)index + 1) * MESH_FLOATS_PER_VERTEX);
+        }
+        index = remap[index];
+    }
+    v.swap(reordered);
+}
+
+void decimateMesh(const float *v, size_t vertexCount, const uint32_t *e, size_t indexCount, int resolution,
+                  std::vector<float> &outV, std::vector<uint32_t> &outE)
+{
+    outV.clear();
+    outE.clear();
+    if (vertexCount == 0 || indexCount < 3)
+        return;
+
+    // Células cúbicas: o maior eixo da caixa recebe resolution divisões
+    glm::vec3 boxMin(v[0], v[1], v[2]);
+    glm::vec3 boxMax = boxMin;
+    for (size_t i = 1; i < vertexCount; i++)
+    {
+        const float *p = v + i * MESH_FLOATS_PER_VERTEX;
+        boxMin = glm::min(boxMin, glm::vec3(p[0], p[1], p[2]));
+        boxMax = glm::max(boxMax, glm::vec3(p[0], p[1], p[2]));
+    }
+    glm::vec3 extent = boxMax - boxMin;
+    float cellSize = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f)) / (float)std::max(1, resolution);
+    glm::ivec3 dims = glm::max(glm::ivec3(glm::ceil(extent / cellSize)), glm::ivec3(1));
+
+    // Grade densa célula -> grupo (resolution pequena: no máximo alguns MB)
+    std::vector<int> cellCluster((size_t)dims.x * dims.y * dims.z, -1);
+    std::vector<uint32_t> vertexCluster(vertexCount);
+    std::vector<float> sums;   // posição, cor e textura somadas (8 floats), depois a normal (3)
+    std::vector<uint32_t> counts;
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        const float *p = v + i * MESH_FLOATS_PER_VERTEX;
+        glm::ivec3 c = glm::clamp(glm::ivec3((glm::vec3(p[0], p[1], p[2]) - boxMin) / cellSize), glm::ivec3(0), dims - 1);
+        int &cluster = cellCluster[((size_t)c.z * dims.y + c.y) * dims.x + c.x];
+        if (cluster < 0)
+        {
+            cluster = (int)counts.size();
+            counts.push_back(0);
+            sums.resize(sums.size() + MESH_FLOATS_PER_VERTEX, 0.0f);
+        }
+        float *sum = sums.data() + (size_t)cluster * MESH_FLOATS_PER_VERTEX;
+        for (int f = 0; f < MESH_FLOATS_PER_VERTEX; f++)
+            sum[f] += p[f];
+        counts[cluster]++;
+        vertexCluster[i] = (uint32_t)cluster;
+    }
+
+    // Representante de cada grupo: média dos atributos, normal renormalizada
+    outV.resize(sums.size());
+    for (size_t c = 0; c < counts.size(); c++)
+    {
+        const float *sum = sums.data() + c * MESH_FLOATS_PER_VERTEX;
+        float *out = outV.data() + c * MESH_FLOATS_PER_VERTEX;
+        for (int f = 0; f < 8; f++)
+            out[f] = sum[f] / (float)counts[c];
+        glm::vec3 normal(sum[8], sum[9], sum[10]);
+        float length = glm::length(normal);
+        normal = length > 1e-6f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        out[8] = normal.x;
+        out[9] = normal.y;
+        out[10] = normal.z;
+    }
+
+    // Triângulos com dois cantos no mesmo grupo viraram linha ou ponto
+    for (size_t t = 0; t + 2 < indexCount; t += 3)
+    {
+        uint32_t a = vertexCluster[e[t]];
+        uint32_t b = vertexCluster[e[t + 1]];
+        uint32_t c = vertexCluster[e[t + 2]];
+        if (a == b || b == c || a == c)
+            continue;
+        outE.push_back(a);
+        outE.push_back(b);
+        outE.push_back(c);
+    }
+
+    // Grupos sem triângulo sobram; a renumeração pelo uso descarta
+    optimizeVertexCache(outE, counts.size());
+    reorderVertices(outV, outE);
+}
+
+void impostorMesh(const float *v, size_t vertexCount, std::vector<float> &outV, std::vector<uint32_t> &outE)
+{
+    float color[3] = {0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        for (int f = 0; f < 3; f++)
+            color[f] += v[i * MESH_FLOATS_PER_VERTEX + 3 + f];
+    }
+    float scale = vertexCount > 0 ? 1.0f / (float)vertexCount : 0.0f;
+    const float vertex[MESH_FLOATS_PER_VERTEX] = {0.0f, 0.0f, 0.0f, color[0] * scale, color[1] * scale, color[2] * scale,
+                                                  0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+    outV.assign(vertex, vertex + MESH_FLOATS_PER_VERTEX);
+    outE.assign(1, 0);
+}
+
+float averageCacheMissRatio(const std::vector<uint32_t> &e, size_t vertexCount, int cacheSize)
+{
+    if (e.size() < 3)
+        return 0.0f;
+
+    // Cache FIFO: um vértice está no cache se entrou há menos de cacheSize faltas
+    std::vector<size_t> insertedAt(vertexCount, 0); // número da falta + 1; 0 = nunca entrou
+    size_t misses = 0;
+    for (uint32_t index : e)
+    {
+        if (insertedAt[index] == 0 || misses - (insertedAt[index] - 1) >= (size_t)cacheSize)
+        {
+            insertedAt[index] = misses + 1;
+            misses++;
+        }
+    }
+    return (float)misses / (float)(e.size() / 3);
+}
+
+Mesh loadMesh(const std::string &path, float r, float g, float b, bool optimize)
+{
+    TRACE_ZONE("loadMesh");
+    Mesh mesh;
+    const float color[3] = {r, g, b};
+
+    std::error_code error;
+    uint64_t sourceSize = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        std::cerr << "Erro ao abrir arquivo " << path << std::endl;
+        return mesh;
+    }
+    int64_t sourceTime = (int64_t)std::filesystem::last_write_time(path, error).time_since_epoch().count();
+
+    std::string cachePath = path + ".mesh";
+    if (mesh.mapCache(cachePath, sourceSize, sourceTime, color, optimize))
+        return mesh;
+
+    std::vector<float> v;
+    std::vector<uint32_t> e;
+    if (!objLoader(v, e, path, r, g, b))
+        return mesh;
+
+    // Sem deduplicação cada canto de face seria um vértice próprio.
+    // A linha é montada antes para não se misturar com outras threads.
+    size_t vertexCount = v.size() / MESH_FLOATS_PER_VERTEX;
+    float missRatio = averageCacheMissRatio(e, vertexCount);
+    std::ostringstream report;
+    report << path << ": " << e.size() << " -> " << vertexCount << " vertices";
+    if (optimize)
+    {
+        optimizeVertexCache(e, vertexCount);
+        reorderVertices(v, e);
+        report << ", ACMR " << missRatio << " -> " << averageCacheMissRatio(e, vertexCount);
+    }
+    report << "\n";
+    std::cout << report.str() << std::flush;
+
+    writeMeshCache(cachePath, v, e, sourceSize, sourceTime, color, optimize);
+    mesh.assign(std::move(v), std::move(e));
+    return mesh;
+}
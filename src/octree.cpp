@@ -0,0 +1,208 @@
+#include "octree.hpp"
+
+// Folhas param de dividir com poucos boids ou em profundidade máxima
+// (boids empilhados no mesmo ponto nunca se separariam)
+static const int OCTREE_LEAF_SIZE = 16;
+static const int OCTREE_MAX_DEPTH = 16;
+
+FlockOctree::FlockOctree() : openingAngle(0.5f)
+{
+}
+
+void FlockOctree::setOpeningAngle(float angle)
+{
+    openingAngle = glm::clamp(angle, 0.0f, 0.5f);
+}
+
+float FlockOctree::getOpeningAngle() const
+{
+    return openingAngle;
+}
+
+void FlockOctree::build(const BoidSoA& state)
+{
+    size_t count = state.size();
+    nodes.clear();
+    items.resize(count);
+    scratch.resize(count);
+    positions.resize(count);
+    velocities.resize(count);
+    if (count == 0)
+        return;
+
+    glm::vec3 minBound(state.px[0], state.py[0], state.pz[0]);
+    glm::vec3 maxBound = minBound;
+    for (size_t slot = 0; slot < count; slot++)
+    {
+        positions[slot] = glm::vec3(state.px[slot], state.py[slot], state.pz[slot]);
+        velocities[slot] = glm::vec3(state.vx[slot], state.vy[slot], state.vz[slot]);
+        minBound = glm::min(minBound, positions[slot]);
+        maxBound = glm::max(maxBound, positions[slot]);
+        items[slot] = (int)slot;
+    }
+
+    // Raiz cúbica envolvendo todos os boids
+    Node root;
+    root.center = (minBound + maxBound) * 0.5f;
+    root.halfSize = glm::max(glm::max(maxBound.x - minBound.x, maxBound.y - minBound.y), maxBound.z - minBound.z) * 0.5f + 1e-3f;
+    root.begin = 0;
+    root.end = (int)count;
+    nodes.push_back(root);
+    buildNode(0, 0);
+
+    // Folhas leem trechos contíguos: copia para a ordem da árvore
+    leafPositions.resize(count);
+    leafVelocities.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        leafPositions[i] = positions[items[i]];
+        leafVelocities[i] = velocities[items[i]];
+    }
+}
+
+void FlockOctree::buildNode(int nodeIndex, int depth)
+{
+    // Cópias locais: nodes pode realocar ao criar os filhos
+    const glm::vec3 center = nodes[nodeIndex].center;
+    const float halfSize = nodes[nodeIndex].halfSize;
+    const int begin = nodes[nodeIndex].begin;
+    const int end = nodes[nodeIndex].end;
+
+    if (end - begin <= OCTREE_LEAF_SIZE || depth >= OCTREE_MAX_DEPTH)
+    {
+        glm::vec3 positionSum(0.0f), velocitySum(0.0f);
+        for (int i = begin; i < end; i++)
+        {
+            positionSum += positions[items[i]];
+            velocitySum += velocities[items[i]];
+        }
+        Node& node = nodes[nodeIndex];
+        node.positionSum = positionSum;
+        node.velocitySum = velocitySum;
+        node.count = end - begin;
+        node.firstChild = -1;
+        return;
+    }
+
+    // Particiona o trecho em octantes (counting sort de 8 baldes)
+    auto octantOf = [&](int slot)
+    {
+        const glm::vec3& p = positions[slot];
+        return (p.x >= center.x ? 1 : 0) | (p.y >= center.y ? 2 : 0) | (p.z >= center.z ? 4 : 0);
+    };
+    int octantStart[9] = {0};
+    for (int i = begin; i < end; i++)
+        octantStart[octantOf(items[i]) + 1]++;
+    for (int o = 0; o < 8; o++)
+        octantStart[o + 1] += octantStart[o];
+    int cursor[8];
+    for (int o = 0; o < 8; o++)
+        cursor[o] = begin + octantStart[o];
+    for (int i = begin; i < end; i++)
+    {
+        int slot = items[i];
+        scratch[cursor[octantOf(slot)]++] = slot;
+    }
+    for (int i = begin; i < end; i++)
+        items[i] = scratch[i];
+
+    int firstChild = (int)nodes.size();
+    nodes[nodeIndex].firstChild = firstChild;
+    float childHalf = halfSize * 0.5f;
+    for (int o = 0; o < 8; o++)
+    {
+        Node child;
+        child.center = center + glm::vec3((o & 1) ? childHalf : -childHalf,
+                                          (o & 2) ? childHalf : -childHalf,
+                                          (o & 4) ? childHalf : -childHalf);
+        child.halfSize = childHalf;
+        child.begin = begin + octantStart[o];
+        child.end = begin + octantStart[o + 1];
+        nodes.push_back(child);
+    }
+
+    glm::vec3 positionSum(0.0f), velocitySum(0.0f);
+    for (int o = 0; o < 8; o++)
+    {
+        buildNode(firstChild + o, depth + 1);
+        positionSum += nodes[firstChild + o].positionSum;
+        velocitySum += nodes[firstChild + o].velocitySum;
+    }
+    Node& node = nodes[nodeIndex];
+    node.positionSum = positionSum;
+    node.velocitySum = velocitySum;
+    node.count = end - begin;
+}
+
+void FlockOctree::accumulate(glm::vec3 position, float radius, NeighborSums& sums) const
+{
+    if (nodes.empty())
+        return;
+
+    const float radiusSq = radius * radius;
+    const float angleSq = openingAngle * openingAngle;
+
+    // Pilha explícita: no máximo 7 irmãos pendentes por nível
+    int stack[8 * OCTREE_MAX_DEPTH + 8];
+    int top = 0;
+    if (nodes[0].count > 0)
+        stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = nodes[stack[--top]];
+
+        // Caixa toda fora do raio: nada a somar
+        glm::vec3 offset = glm::abs(position - node.center);
+        glm::vec3 outside = glm::max(offset - node.halfSize, 0.0f);
+        if (glm::dot(outside, outside) >= radiusSq)
+            continue;
+
+        // Caixa toda dentro do raio: o agregado é exato
+        glm::vec3 farthest = offset + node.halfSize;
+        bool whole = glm::dot(farthest, farthest) < radiusSq;
+
+        // Nó pequeno visto de longe: entra se o centro de massa estiver no raio
+        if (!whole)
+        {
+            glm::vec3 toCenterOfMass = node.positionSum / (float)node.count - position;
+            float distanceSq = glm::dot(toCenterOfMass, toCenterOfMass);
+            float size = node.halfSize * 2.0f;
+            if (size * size < angleSq * distanceSq)
+            {
+                if (distanceSq >= radiusSq)
+                    continue;
+                whole = true;
+            }
+        }
+
+        if (whole)
+        {
+            sums.positionSum += node.positionSum;
+            sums.velocitySum += node.velocitySum;
+            sums.neighborCount += node.count;
+        }
+        else if (node.firstChild < 0)
+        {
+            for (int i = node.begin; i < node.end; i++)
+            {
+                const glm::vec3& other = leafPositions[i];
+                glm::vec3 diff = position - other;
+                if (glm::dot(diff, diff) < radiusSq)
+                {
+                    sums.positionSum += other;
+                    sums.velocitySum += leafVelocities[i];
+                    sums.neighborCount++;
+                }
+            }
+        }
+        else
+        {
+            for (int o = 0; o < 8; o++)
+            {
+                if (nodes[node.firstChild + o].count > 0)
+                    stack[top++] = node.firstChild + o;
+            }
+        }
+    }
+}
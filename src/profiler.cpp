@@ -0,0 +1,243 @@
+#include "profiler.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cstdio>
+
+// Nomes sem acento: a fonte do overlay só tem ASCII
+static const char *SECTION_NAMES[PROFILE_SECTION_COUNT] = {
+    "ENTRADA", "SIMULACAO", "CAMERA", "TERRENO", "BOIDS",
+    "ARVORES", "FUSCA", "LUZ", "OVERLAY", "SWAP"};
+
+static const char *SECTION_COLUMNS[PROFILE_SECTION_COUNT] = {
+    "entrada", "simulacao", "camera", "terreno", "boids",
+    "arvores", "fusca", "luz", "overlay", "swap"};
+
+void FrameProfiler::History::push(float value)
+{
+    samples[next] = value;
+    next = (next + 1) % PROFILER_HISTORY;
+    if (count < PROFILER_HISTORY)
+        count++;
+}
+
+ProfileStats FrameProfiler::History::stats() const
+{
+    ProfileStats result = {0.0f, 0.0f, 0.0f, 0.0f, count};
+    if (count == 0)
+        return result;
+
+    float sorted[PROFILER_HISTORY];
+    std::copy(samples, samples + count, sorted);
+    std::sort(sorted, sorted + count);
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++)
+        sum += sorted[i];
+    auto percentile = [&](float p)
+    {
+        return sorted[std::min(count - 1, (int)(p * (count - 1) + 0.5f))];
+    };
+    result.average = sum / count;
+    result.p50 = percentile(0.50f);
+    result.p95 = percentile(0.95f);
+    result.p99 = percentile(0.99f);
+    return result;
+}
+
+FrameProfiler::FrameProfiler() : initialized(false), frameIndex(0), droppedFrames(0), traceFrameStart(0)
+{
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+        traceSectionStart[s] = 0;
+    for (int slot = 0; slot < PROFILER_QUERY_FRAMES; slot++)
+        for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+            queries[slot][s] = 0;
+}
+
+void FrameProfiler::init()
+{
+    if (initialized)
+        return;
+    glGenQueries(PROFILER_QUERY_FRAMES * PROFILE_SECTION_COUNT, &queries[0][0]);
+    initialized = true;
+}
+
+void FrameProfiler::Delete()
+{
+    if (!initialized)
+        return;
+    glDeleteQueries(PROFILER_QUERY_FRAMES * PROFILE_SECTION_COUNT, &queries[0][0]);
+    initialized = false;
+    csv.close();
+}
+
+bool FrameProfiler::openCsv(const std::string &path)
+{
+    csv.open(path);
+    if (!csv.is_open())
+        return false;
+    csv << "quadro,quadro_ms";
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+        csv << "," << SECTION_COLUMNS[s] << "_cpu_ms";
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+        csv << "," << SECTION_COLUMNS[s] << "_gpu_ms";
+    csv << "\n";
+    return true;
+}
+
+void FrameProfiler::beginFrame()
+{
+    int slot = (int)(frameIndex % PROFILER_QUERY_FRAMES);
+    PendingFrame &frame = pending[slot];
+    // Resolve o quadro que usou este slot PROFILER_QUERY_FRAMES quadros atrás
+    if (frame.frame >= 0)
+        resolve(frame, slot);
+
+    frame.frame = frameIndex;
+    frame.frameMs = 0.0f;
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+    {
+        frame.cpuMs[s] = 0.0f;
+        frame.gpuIssued[s] = false;
+    }
+    frameStart = Clock::now();
+    traceFrameStart = tracingEnabled() ? traceNow() : 0;
+}
+
+void FrameProfiler::endFrame()
+{
+    PendingFrame &frame = pending[frameIndex % PROFILER_QUERY_FRAMES];
+    frame.frameMs = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+    if (traceFrameStart && tracingEnabled())
+        traceRecord("quadro", traceFrameStart, traceNow());
+    // O primeiro quadro carrega a inicialização preguiçosa do driver
+    // (compilação de shaders, alocações): fica fora das estatísticas
+    if (frameIndex == 0)
+        frame.frame = -1;
+    else
+    {
+        frameHistory.push(frame.frameMs);
+        for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+            cpuHistory[s].push(frame.cpuMs[s]);
+    }
+    frameIndex++;
+}
+
+void FrameProfiler::begin(ProfileSection section, bool gpu)
+{
+    int s = (int)section;
+    if (gpu && initialized)
+    {
+        glBeginQuery(GL_TIME_ELAPSED, queries[frameIndex % PROFILER_QUERY_FRAMES][s]);
+        pending[frameIndex % PROFILER_QUERY_FRAMES].gpuIssued[s] = true;
+    }
+    sectionStart[s] = Clock::now();
+    traceSectionStart[s] = tracingEnabled() ? traceNow() : 0;
+}
+
+void FrameProfiler::end(ProfileSection section)
+{
+    int s = (int)section;
+    PendingFrame &frame = pending[frameIndex % PROFILER_QUERY_FRAMES];
+    // += : um trecho pode ser aberto mais de uma vez no quadro
+    frame.cpuMs[s] += std::chrono::duration<float, std::milli>(Clock::now() - sectionStart[s]).count();
+    if (frame.gpuIssued[s])
+        glEndQuery(GL_TIME_ELAPSED);
+    if (traceSectionStart[s] && tracingEnabled())
+        traceRecord(SECTION_COLUMNS[s], traceSectionStart[s], traceNow());
+}
+
+void FrameProfiler::resolve(PendingFrame &frame, int slot)
+{
+    // Só lê se todas as queries do quadro já tiverem resultado; senão o quadro
+    // é descartado em vez de travar a CPU esperando a GPU
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+    {
+        if (!frame.gpuIssued[s])
+            continue;
+        GLint available = 0;
+        glGetQueryObjectiv(queries[slot][s], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            droppedFrames++;
+            frame.frame = -1;
+            return;
+        }
+    }
+
+    float gpuMs[PROFILE_SECTION_COUNT];
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+    {
+        gpuMs[s] = -1.0f;
+        if (!frame.gpuIssued[s])
+            continue;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[slot][s], GL_QUERY_RESULT, &nanoseconds);
+        gpuMs[s] = (float)(nanoseconds * 1e-6);
+        gpuHistory[s].push(gpuMs[s]);
+    }
+
+    if (csv.is_open())
+    {
+        csv << frame.frame << "," << frame.frameMs;
+        for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+            csv << "," << frame.cpuMs[s];
+        // Trecho sem query de GPU fica vazio
+        for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+        {
+            csv << ",";
+            if (gpuMs[s] >= 0.0f)
+                csv << gpuMs[s];
+        }
+        csv << "\n";
+    }
+    frame.frame = -1;
+}
+
+ProfileStats FrameProfiler::frameStats() const
+{
+    return frameHistory.stats();
+}
+
+ProfileStats FrameProfiler::cpuStats(ProfileSection section) const
+{
+    return cpuHistory[(int)section].stats();
+}
+
+ProfileStats FrameProfiler::gpuStats(ProfileSection section) const
+{
+    return gpuHistory[(int)section].stats();
+}
+
+std::string FrameProfiler::report() const
+{
+    std::string text;
+    char line[160];
+
+    ProfileStats frame = frameStats();
+    std::snprintf(line, sizeof(line), "QUADRO %6.2f MS (%.0f FPS)  P50 %.2f  P95 %.2f  P99 %.2f\n",
+                  frame.average, frame.average > 0.0f ? 1000.0f / frame.average : 0.0f,
+                  frame.p50, frame.p95, frame.p99);
+    text += line;
+    std::snprintf(line, sizeof(line), "%-10s %7s %6s %6s | %7s %6s %6s\n",
+                  "MS", "CPU", "P95", "P99", "GPU", "P95", "P99");
+    text += line;
+
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++)
+    {
+        ProfileStats cpu = cpuHistory[s].stats();
+        ProfileStats gpu = gpuHistory[s].stats();
+        if (gpu.samples > 0)
+            std::snprintf(line, sizeof(line), "%-10s %7.3f %6.3f %6.3f | %7.3f %6.3f %6.3f\n",
+                          SECTION_NAMES[s], cpu.average, cpu.p95, cpu.p99, gpu.average, gpu.p95, gpu.p99);
+        else
+            std::snprintf(line, sizeof(line), "%-10s %7.3f %6.3f %6.3f | %7s\n",
+                          SECTION_NAMES[s], cpu.average, cpu.p95, cpu.p99, "-");
+        text += line;
+    }
+
+    if (droppedFrames > 0)
+    {
+        std::snprintf(line, sizeof(line), "GPU: %lld QUADROS SEM RESULTADO A TEMPO\n", droppedFrames);
+        text += line;
+    }
+    return text;
+}
@@ -0,0 +1,19 @@
+#include "random.hpp"
+
+static unsigned int globalSeed = 1;
+
+void setGlobalSeed(unsigned int seed)
+{
+    globalSeed = seed;
+}
+
+unsigned int getGlobalSeed()
+{
+    return globalSeed;
+}
+
+std::mt19937 makeRandomStream(RandomStream stream)
+{
+    std::seed_seq seq{globalSeed, static_cast<unsigned int>(stream)};
+    return std::mt19937(seq);
+}
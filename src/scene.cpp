@@ -0,0 +1,34 @@
+#include "scene.hpp"
+#include "random.hpp"
+
+std::vector<Tree> globalTrees;
+TreeGrid globalTreeGrid;
+
+void placeTrees(int numTrees, float area)
+{
+    std::mt19937 treeGen = makeRandomStream(RandomStream::Trees);
+    std::uniform_real_distribution<float> treePosX(-area, area);
+    std::uniform_real_distribution<float> treePosZ(-area, area);
+    std::uniform_real_distribution<float> treeRadius(0.5f, 1.0f);
+    std::uniform_real_distribution<float> treeHeight(20.0f, 100.0f);
+
+    globalTrees.clear();
+    globalTrees.reserve(numTrees + 1);
+    for (int i = 0; i < numTrees; i++)
+    {
+        Tree tree;
+        tree.position = glm::vec3(treePosX(treeGen), -5.0f, treePosZ(treeGen));
+        tree.radius = treeRadius(treeGen);
+        tree.height = treeHeight(treeGen);
+        globalTrees.push_back(tree);
+    }
+
+    Tree centralTree;
+    centralTree.height = 100.0f;
+    centralTree.radius = 0.5f;
+    centralTree.position = glm::vec3(0.0f, 0.0f, 0.0f);
+    globalTrees.push_back(centralTree);
+
+    // Célula do tamanho do raio de detecção: cada consulta vê 3x3 células
+    globalTreeGrid.build(globalTrees, OBSTACLE_DETECTION_RADIUS);
+}
@@ -1,4 +1,7 @@
 #include "shaderClass.hpp"
+#include "glCompute.hpp"
+#include "trace.hpp"
+#include <glm/gtc/type_ptr.hpp>
 
 // Reads a text file and outputs a string with everything in the text file
 std::string get_file_contents(const char *filename)
@@ -21,6 +24,7 @@ std::string get_file_contents(const char *filename)
 // Constructor that build the Shader Program from 2 different shaders
 Shader::Shader(const char *vertexFile, const char *fragmentFile)
 {
+	TRACE_ZONE("Shader::compile");
 	// Read vertexFile and fragmentFile and store the strings
 	std::string vertexCode = get_file_contents(vertexFile);
 	std::string fragmentCode = get_file_contents(fragmentFile);
@@ -53,6 +57,32 @@ Shader::Shader(const char *vertexFile, const char *fragmentFile)
 	// deleta os shaders pois já foram carregados para o programa principal
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
+
+	cacheUniformLocations();
+}
+
+// Constructor that build a compute-only Shader Program
+Shader::Shader(const char *computeFile)
+{
+	TRACE_ZONE("Shader::compile");
+	std::string computeCode = get_file_contents(computeFile);
+	const char *computeSource = computeCode.c_str();
+
+	// cria e compila o compute shader
+	GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(computeShader, 1, &computeSource, NULL);
+	glCompileShader(computeShader);
+	compileErrors(computeShader, "COMPUTE");
+
+	// programa só com ele
+	ID = glCreateProgram();
+	glAttachShader(ID, computeShader);
+	glLinkProgram(ID);
+	compileErrors(ID, "PROGRAM");
+
+	glDeleteShader(computeShader);
+
+	cacheUniformLocations();
 }
 
 // Activates the Shader Program
@@ -67,6 +97,102 @@ void Shader::Delete()
 	glDeleteProgram(ID);
 }
 
+// Resolves every active uniform once, right after linking
+void Shader::cacheUniformLocations()
+{
+	GLint numUniforms = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &numUniforms);
+
+	char name[256];
+	for (GLint i = 0; i < numUniforms; i++)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ID, (GLuint)i, sizeof(name), &length, &size, &type, name);
+		std::string uniformName(name, length);
+		GLint location = glGetUniformLocation(ID, name);
+		uniformLocations[uniformName] = location;
+
+		// Arrays are reported as "name[0]"; also answer to plain "name"
+		size_t bracket = uniformName.find('[');
+		if (bracket != std::string::npos)
+			uniformLocations[uniformName.substr(0, bracket)] = location;
+	}
+}
+
+GLint Shader::GetUniformLocation(const char *name)
+{
+	auto it = uniformLocations.find(name);
+	if (it != uniformLocations.end())
+		return it->second;
+
+	// Not active (e.g. optimized out): ask once and remember the answer (-1)
+	GLint location = glGetUniformLocation(ID, name);
+	uniformLocations.emplace(name, location);
+	return location;
+}
+
+void Shader::SetInt(GLint location, GLint value)
+{
+	glUniform1i(location, value);
+}
+
+void Shader::SetFloat(GLint location, GLfloat value)
+{
+	glUniform1f(location, value);
+}
+
+void Shader::SetVec2(GLint location, const glm::vec2 &value)
+{
+	glUniform2f(location, value.x, value.y);
+}
+
+void Shader::SetVec3(GLint location, const glm::vec3 &value)
+{
+	glUniform3f(location, value.x, value.y, value.z);
+}
+
+void Shader::SetVec4(GLint location, const glm::vec4 &value)
+{
+	glUniform4f(location, value.x, value.y, value.z, value.w);
+}
+
+void Shader::SetMat4(GLint location, const glm::mat4 &value)
+{
+	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::SetInt(const char *name, GLint value)
+{
+	SetInt(GetUniformLocation(name), value);
+}
+
+void Shader::SetFloat(const char *name, GLfloat value)
+{
+	SetFloat(GetUniformLocation(name), value);
+}
+
+void Shader::SetVec2(const char *name, const glm::vec2 &value)
+{
+	SetVec2(GetUniformLocation(name), value);
+}
+
+void Shader::SetVec3(const char *name, const glm::vec3 &value)
+{
+	SetVec3(GetUniformLocation(name), value);
+}
+
+void Shader::SetVec4(const char *name, const glm::vec4 &value)
+{
+	SetVec4(GetUniformLocation(name), value);
+}
+
+void Shader::SetMat4(const char *name, const glm::mat4 &value)
+{
+	SetMat4(GetUniformLocation(name), value);
+}
+
 // Checks if the different Shaders have compiled properly
 void Shader::compileErrors(unsigned int shader, const char *type)
 {
@@ -0,0 +1,170 @@
+#include "textOverlay.hpp"
+#include <algorithm>
+#include <cctype>
+
+// Fonte 5x7: 7 linhas de 5 colunas por caractere, '#' = pixel aceso
+struct Glyph
+{
+    char character;
+    const char *rows[7];
+};
+
+static const Glyph FONT[] = {
+    {'A', {".###.", "#...#", "#...#", "#####", "#...#", "#...#", "#...#"}},
+    {'B', {"####.", "#...#", "#...#", "####.", "#...#", "#...#", "####."}},
+    {'C', {".###.", "#...#", "#....", "#....", "#....", "#...#", ".###."}},
+    {'D', {"####.", "#...#", "#...#", "#...#", "#...#", "#...#", "####."}},
+    {'E', {"#####", "#....", "#....", "####.", "#....", "#....", "#####"}},
+    {'F', {"#####", "#....", "#....", "####.", "#....", "#....", "#...."}},
+    {'G', {".###.", "#...#", "#....", "#.###", "#...#", "#...#", ".####"}},
+    {'H', {"#...#", "#...#", "#...#", "#####", "#...#", "#...#", "#...#"}},
+    {'I', {".###.", "..#..", "..#..", "..#..", "..#..", "..#..", ".###."}},
+    {'J', {"..###", "...#.", "...#.", "...#.", "...#.", "#..#.", ".##.."}},
+    {'K', {"#...#", "#..#.", "#.#..", "##...", "#.#..", "#..#.", "#...#"}},
+    {'L', {"#....", "#....", "#....", "#....", "#....", "#....", "#####"}},
+    {'M', {"#...#", "##.##", "#.#.#", "#.#.#", "#...#", "#...#", "#...#"}},
+    {'N', {"#...#", "#...#", "##..#", "#.#.#", "#..##", "#...#", "#...#"}},
+    {'O', {".###.", "#...#", "#...#", "#...#", "#...#", "#...#", ".###."}},
+    {'P', {"####.", "#...#", "#...#", "####.", "#....", "#....", "#...."}},
+    {'Q', {".###.", "#...#", "#...#", "#...#", "#.#.#", "#..#.", ".##.#"}},
+    {'R', {"####.", "#...#", "#...#", "####.", "#.#..", "#..#.", "#...#"}},
+    {'S', {".####", "#....", "#....", ".###.", "....#", "....#", "####."}},
+    {'T', {"#####", "..#..", "..#..", "..#..", "..#..", "..#..", "..#.."}},
+    {'U', {"#...#", "#...#", "#...#", "#...#", "#...#", "#...#", ".###."}},
+    {'V', {"#...#", "#...#", "#...#", "#...#", "#...#", ".#.#.", "..#.."}},
+    {'W', {"#...#", "#...#", "#...#", "#.#.#", "#.#.#", "#.#.#", ".#.#."}},
+    {'X', {"#...#", "#...#", ".#.#.", "..#..", ".#.#.", "#...#", "#...#"}},
+    {'Y', {"#...#", "#...#", ".#.#.", "..#..", "..#..", "..#..", "..#.."}},
+    {'Z', {"#####", "....#", "...#.", "..#..", ".#...", "#....", "#####"}},
+    {'0', {".###.", "#...#", "#..##", "#.#.#", "##..#", "#...#", ".###."}},
+    {'1', {"..#..", ".##..", "..#..", "..#..", "..#..", "..#..", ".###."}},
+    {'2', {".###.", "#...#", "....#", "...#.", "..#..", ".#...", "#####"}},
+    {'3', {"#####", "...#.", "..#..", "...#.", "....#", "#...#", ".###."}},
+    {'4', {"...#.", "..##.", ".#.#.", "#..#.", "#####", "...#.", "...#."}},
+    {'5', {"#####", "#....", "####.", "....#", "....#", "#...#", ".###."}},
+    {'6', {"..##.", ".#...", "#....", "####.", "#...#", "#...#", ".###."}},
+    {'7', {"#####", "....#", "...#.", "..#..", ".#...", ".#...", ".#..."}},
+    {'8', {".###.", "#...#", "#...#", ".###.", "#...#", "#...#", ".###."}},
+    {'9', {".###.", "#...#", "#...#", ".####", "....#", "...#.", ".##.."}},
+    {'.', {".....", ".....", ".....", ".....", ".....", ".##..", ".##.."}},
+    {',', {".....", ".....", ".....", ".....", ".##..", "..#..", ".#..."}},
+    {':', {".....", ".##..", ".##..", ".....", ".##..", ".##..", "....."}},
+    {'-', {".....", ".....", ".....", "#####", ".....", ".....", "....."}},
+    {'+', {".....", "..#..", "..#..", "#####", "..#..", "..#..", "....."}},
+    {'=', {".....", ".....", "#####", ".....", "#####", ".....", "....."}},
+    {'/', {".....", "....#", "...#.", "..#..", ".#...", "#....", "....."}},
+    {'%', {"##...", "##..#", "...#.", "..#..", ".#...", "#..##", "...##"}},
+    {'(', {"...#.", "..#..", ".#...", ".#...", ".#...", "..#..", "...#."}},
+    {')', {".#...", "..#..", "...#.", "...#.", "...#.", "..#..", ".#..."}},
+    {'|', {"..#..", "..#..", "..#..", "..#..", "..#..", "..#..", "..#.."}},
+    {'_', {".....", ".....", ".....", ".....", ".....", ".....", "#####"}},
+};
+
+static const int GLYPH_WIDTH = 5;
+static const int GLYPH_HEIGHT = 7;
+// Avanço entre caracteres e linhas, em pixels da fonte
+static const int GLYPH_ADVANCE = 6;
+static const int LINE_ADVANCE = 9;
+static const int MARGIN = 4;
+
+static const Glyph *findGlyph(char c)
+{
+    c = (char)std::toupper((unsigned char)c);
+    for (const Glyph &glyph : FONT)
+    {
+        if (glyph.character == c)
+            return &glyph;
+    }
+    return nullptr;
+}
+
+TextOverlay::TextOverlay(const char *vertexFile, const char *fragmentFile)
+    : shader(vertexFile, fragmentFile), vbo(nullptr, 0, GL_DYNAMIC_DRAW)
+{
+    vao.Bind();
+    vao.LinkAttrib(vbo, 0, 2, GL_FLOAT, 2 * sizeof(GLfloat), (void *)0);
+    vao.Unbind();
+}
+
+void TextOverlay::pushQuad(float x, float y, float width, float height)
+{
+    const GLfloat quad[12] = {x, y, x + width, y, x + width, y + height,
+                              x, y, x + width, y + height, x, y + height};
+    vertices.insert(vertices.end(), quad, quad + 12);
+}
+
+void TextOverlay::SetText(const std::string &text)
+{
+    vertices.clear();
+    // Reserva o fundo e preenche depois, quando o tamanho do texto é conhecido
+    pushQuad(0.0f, 0.0f, 0.0f, 0.0f);
+
+    float unit = (float)scale;
+    int column = 0, line = 0, widest = 0;
+    for (char c : text)
+    {
+        if (c == '\n')
+        {
+            column = 0;
+            line++;
+            continue;
+        }
+        const Glyph *glyph = findGlyph(c);
+        float originX = MARGIN * unit + column * GLYPH_ADVANCE * unit;
+        float originY = MARGIN * unit + line * LINE_ADVANCE * unit;
+        column++;
+        if (column > widest)
+            widest = column;
+        if (!glyph)
+            continue;
+        for (int row = 0; row < GLYPH_HEIGHT; row++)
+        {
+            for (int col = 0; col < GLYPH_WIDTH; col++)
+            {
+                if (glyph->rows[row][col] == '#')
+                    pushQuad(originX + col * unit, originY + row * unit, unit, unit);
+            }
+        }
+    }
+    int lines = line + ((!text.empty() && text.back() != '\n') ? 1 : 0);
+
+    float backgroundWidth = (2 * MARGIN + widest * GLYPH_ADVANCE) * unit;
+    float backgroundHeight = (2 * MARGIN + lines * LINE_ADVANCE) * unit;
+    const GLfloat background[12] = {0.0f, 0.0f, backgroundWidth, 0.0f, backgroundWidth, backgroundHeight,
+                                    0.0f, 0.0f, backgroundWidth, backgroundHeight, 0.0f, backgroundHeight};
+    std::copy(background, background + 12, vertices.begin());
+
+    textVertexCount = (GLsizei)(vertices.size() / 2) - 6;
+    vbo.Update(vertices.data(), vertices.size() * sizeof(GLfloat));
+}
+
+void TextOverlay::Draw(int screenWidth, int screenHeight)
+{
+    if (vertices.empty() || screenWidth <= 0 || screenHeight <= 0)
+        return;
+
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    shader.Activate();
+    shader.SetVec2("screenSize", glm::vec2((float)screenWidth, (float)screenHeight));
+    vao.Bind();
+    shader.SetVec4("color", glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    shader.SetVec4("color", glm::vec4(1.0f, 1.0f, 0.85f, 1.0f));
+    glDrawArrays(GL_TRIANGLES, 6, textVertexCount);
+    vao.Unbind();
+
+    glDisable(GL_BLEND);
+    if (depthTest)
+        glEnable(GL_DEPTH_TEST);
+}
+
+void TextOverlay::Delete()
+{
+    vao.Delete();
+    vbo.Delete();
+    shader.Delete();
+}
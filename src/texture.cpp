@@ -1,16 +1,52 @@
 #include "texture.hpp"
+#include <iostream>
+#include <utility>
 
-Texture::Texture(const char *image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType)
+ImageData::ImageData(const char *image)
 {
-    // Assigns the type of the texture ot the texture object
-    type = texType;
-
-    // guarda as informações da imagem
-    int widthImg, heightImg, numColCh;
     // flipa a imagem pra aparecer de cabeça pra cima
     stbi_set_flip_vertically_on_load(true);
     // lê a imagem do diretório
-    unsigned char *bytes = stbi_load(image, &widthImg, &heightImg, &numColCh, 0);
+    bytes = stbi_load(image, &width, &height, &channels, 0);
+    if (bytes == nullptr)
+        std::cerr << "Erro ao abrir imagem " << image << std::endl;
+}
+
+ImageData::~ImageData()
+{
+    if (bytes)
+        stbi_image_free(bytes);
+}
+
+ImageData::ImageData(ImageData &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+ImageData &ImageData::operator=(ImageData &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (bytes)
+            stbi_image_free(bytes);
+        width = other.width;
+        height = other.height;
+        channels = other.channels;
+        bytes = other.bytes;
+        other.bytes = nullptr;
+    }
+    return *this;
+}
+
+Texture::Texture(const char *image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType)
+    : Texture(ImageData(image), texType, slot, format, pixelType)
+{
+}
+
+Texture::Texture(const ImageData &image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType)
+{
+    // Assigns the type of the texture ot the texture object
+    type = texType;
 
     // gera um objeto de texura
     glGenTextures(1, &ID);
@@ -31,25 +67,20 @@ Texture::Texture(const char *image, GLenum texType, GLenum slot, GLenum format,
     // glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, flatColor);
 
     // Assigns the image to the OpenGL Texture object
-    glTexImage2D(texType, 0, GL_RGBA, widthImg, heightImg, 0, format, pixelType, bytes);
+    glTexImage2D(texType, 0, GL_RGBA, image.width, image.height, 0, format, pixelType, image.bytes);
     // Generates MipMaps
     glGenerateMipmap(texType);
 
-    // Deletes the image data as it is already in the OpenGL Texture object
-    stbi_image_free(bytes);
-
     // Unbinds the OpenGL Texture object so that it can't accidentally be modified
     glBindTexture(texType, 0);
 }
 
 void Texture::texUnit(Shader &shader, const char *uniform, GLuint unit)
 {
-    // Gets the location of the uniform
-    GLuint texUni = glGetUniformLocation(shader.ID, uniform);
     // Shader needs to be activated before changing the value of a uniform
     shader.Activate();
     // Sets the value of the uniform
-    glUniform1i(texUni, unit);
+    shader.SetInt(uniform, unit);
 }
 
 void Texture::Bind()
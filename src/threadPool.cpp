@@ -0,0 +1,134 @@
+#include "threadPool.hpp"
+#include "trace.hpp"
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+    : generation(0), pendingWorkers(0), stopping(false), reservingTrace(false),
+      jobFunc(nullptr), jobContext(nullptr), jobCount(0), jobGrain(1), nextIndex(0)
+{
+    if (numThreads == 0)
+        numThreads = std::thread::hardware_concurrency();
+    if (numThreads == 0)
+        numThreads = 1;
+
+    // A thread que chama parallelFor também trabalha
+    for (unsigned int i = 1; i < numThreads; i++)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::size() const
+{
+    return (unsigned int)workers.size() + 1;
+}
+
+void ThreadPool::run(ChunkFunc func, void* context, size_t count, size_t grain)
+{
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+
+    // Sem workers ou com um único bloco não vale acordar ninguém
+    if (workers.empty() || count <= grain)
+    {
+        func(context, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobFunc = func;
+        jobContext = context;
+        jobCount = count;
+        jobGrain = grain;
+        nextIndex.store(0, std::memory_order_relaxed);
+        pendingWorkers = (unsigned int)workers.size();
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    runChunks();
+
+    // Esperar os workers terminarem os blocos que pegaram
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return pendingWorkers == 0; });
+}
+
+void ThreadPool::reserveTrace()
+{
+    traceReserveThread();
+    if (workers.empty())
+        return;
+
+    // Trabalho vazio: cada worker acorda, cria o anel e não acha blocos
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobFunc = nullptr;
+        jobContext = nullptr;
+        jobCount = 0;
+        jobGrain = 1;
+        nextIndex.store(0, std::memory_order_relaxed);
+        pendingWorkers = (unsigned int)workers.size();
+        reservingTrace = true;
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return pendingWorkers == 0; });
+    reservingTrace = false;
+}
+
+void ThreadPool::runChunks()
+{
+    while (true)
+    {
+        size_t begin = nextIndex.fetch_add(jobGrain, std::memory_order_relaxed);
+        if (begin >= jobCount)
+            break;
+        size_t end = (begin + jobGrain < jobCount) ? begin + jobGrain : jobCount;
+        jobFunc(jobContext, begin, end);
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    setTraceThreadName("pool");
+    unsigned long long seenGeneration = 0;
+    while (true)
+    {
+        bool reserve;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping)
+                return;
+            seenGeneration = generation;
+            reserve = reservingTrace;
+        }
+
+        if (reserve)
+            traceReserveThread();
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingWorkers--;
+        }
+        doneCondition.notify_one();
+    }
+}
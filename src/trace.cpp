@@ -0,0 +1,127 @@
+#include "trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> traceEnabledFlag(false);
+
+struct TraceEvent
+{
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Anel de uma thread: só ela escreve; written cresce sem voltar a zero
+struct TraceBuffer
+{
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+    std::atomic<uint64_t> written{0};
+    uint32_t threadId = 0;
+    const char *threadName = nullptr;
+};
+
+static const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+// Anéis de todas as threads que já gravaram; ficam vivos até o fim do
+// processo para que o dump veja também threads que já terminaram
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> registry;
+
+static thread_local TraceBuffer *localBuffer = nullptr;
+static thread_local const char *localThreadName = nullptr;
+
+void setTracingEnabled(bool enabled)
+{
+    traceEnabledFlag.store(enabled, std::memory_order_relaxed);
+}
+
+void setTraceThreadName(const char *name)
+{
+    localThreadName = name;
+    if (localBuffer)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        localBuffer->threadName = name;
+    }
+}
+
+uint64_t traceNow()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+void traceReserveThread()
+{
+    if (localBuffer)
+        return;
+    std::unique_ptr<TraceBuffer> buffer(new TraceBuffer());
+    buffer->threadName = localThreadName;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer->threadId = (uint32_t)registry.size() + 1;
+    localBuffer = buffer.get();
+    registry.push_back(std::move(buffer));
+}
+
+void traceRecord(const char *name, uint64_t start, uint64_t end)
+{
+    // Primeira zona da thread: cria o anel (única alocação)
+    if (!localBuffer)
+        traceReserveThread();
+
+    uint64_t index = localBuffer->written.load(std::memory_order_relaxed);
+    localBuffer->events[index % TRACE_BUFFER_EVENTS] = {name, start, end};
+    localBuffer->written.store(index + 1, std::memory_order_release);
+}
+
+// Nomes são literais do código, mas aspas e barras quebrariam o JSON
+static void writeJsonString(FILE *file, const char *text)
+{
+    std::fputc('"', file);
+    for (const char *c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            std::fputc('\\', file);
+        std::fputc(*c, file);
+    }
+    std::fputc('"', file);
+}
+
+bool writeTrace(const std::string &path)
+{
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const auto &buffer : registry)
+    {
+        // Metadado com o nome da thread
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                     first ? "" : ",\n", buffer->threadId);
+        first = false;
+        if (buffer->threadName)
+            writeJsonString(file, buffer->threadName);
+        else
+            std::fprintf(file, "\"thread %u\"", buffer->threadId);
+        std::fprintf(file, "}}");
+
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t count = written < TRACE_BUFFER_EVENTS ? written : TRACE_BUFFER_EVENTS;
+        for (uint64_t i = written - count; i < written; i++)
+        {
+            const TraceEvent &event = buffer->events[i % TRACE_BUFFER_EVENTS];
+            // Evento completo ("X"): início e duração em microssegundos
+            std::fprintf(file, ",\n{\"name\":");
+            writeJsonString(file, event.name);
+            std::fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         buffer->threadId, event.start * 1e-3, (event.end - event.start) * 1e-3);
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
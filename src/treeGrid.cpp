@@ -0,0 +1,52 @@
+#include "treeGrid.hpp"
+
+TreeGrid::TreeGrid() : origin(0.0f), invCellSize(1.0f), dims(1)
+{
+}
+
+void TreeGrid::build(const std::vector<Tree>& trees, float cellSize)
+{
+    cellStart.assign(2, 0);
+    sortedTrees.clear();
+    dims = glm::ivec2(1);
+    if (trees.empty())
+        return;
+
+    // Limites justos em torno dos troncos
+    glm::vec2 minBound(trees[0].position.x, trees[0].position.z);
+    glm::vec2 maxBound = minBound;
+    for (const Tree& tree : trees)
+    {
+        glm::vec2 positionXZ(tree.position.x, tree.position.z);
+        minBound = glm::min(minBound, positionXZ);
+        maxBound = glm::max(maxBound, positionXZ);
+    }
+    origin = minBound;
+    invCellSize = 1.0f / cellSize;
+    dims = glm::max(glm::ivec2(glm::ceil((maxBound - minBound) * invCellSize)), glm::ivec2(1));
+
+    size_t numCells = (size_t)dims.x * dims.y;
+    cellStart.assign(numCells + 1, 0);
+    std::vector<int> treeCell(trees.size());
+
+    // Contar quantas árvores caem em cada célula
+    for (size_t i = 0; i < trees.size(); i++)
+    {
+        glm::ivec2 c = cellOf(glm::vec2(trees[i].position.x, trees[i].position.z));
+        treeCell[i] = c.x + dims.x * c.y;
+        cellStart[treeCell[i] + 1]++;
+    }
+
+    // Soma de prefixos e cópia mantendo a ordem original dentro da célula
+    std::vector<int> cellCursor(numCells);
+    for (size_t c = 0; c < numCells; c++)
+    {
+        cellStart[c + 1] += cellStart[c];
+        cellCursor[c] = cellStart[c];
+    }
+    sortedTrees.resize(trees.size());
+    for (size_t i = 0; i < trees.size(); i++)
+    {
+        sortedTrees[cellCursor[treeCell[i]]++] = trees[i];
+    }
+}